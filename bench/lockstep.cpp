@@ -0,0 +1,110 @@
+// lockstep.cpp
+// Measures 9x9 batch throughput with and without the SIMD lanes of lockstep.h: every 9x9 puzzle
+// under boards/9x9/ (or in the files given on the command line) is expanded into many puzzles of
+// the same difficulty by renaming its digits and shuffling rows and columns within their bands,
+// then solved with solveBatch on one thread, once per lane kernel the CPU supports. Prints the
+// puzzles per second for each file and for all of them together.
+//
+// A board file holds one puzzle, or one puzzle per line.
+//
+// Run from the repository root:  ./bench_lockstep [board files...]
+
+#include "batch.h"
+#include "lockstep.h"
+#include "puzzles.h"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+    constexpr int variants = 20000; // puzzles per board
+
+    // digits renamed, rows shuffled within each band and columns within each stack
+    std::string shuffled(const std::string& puzzle, std::mt19937& rng)
+    {
+        int digits[9], rows[9], cols[9];
+        for (int i = 0; i < 9; ++i)
+            digits[i] = rows[i] = cols[i] = i;
+        std::shuffle(digits, digits + 9, rng);
+        for (int band = 0; band < 9; band += 3)
+        {
+            std::shuffle(rows + band, rows + band + 3, rng);
+            std::shuffle(cols + band, cols + band + 3, rng);
+        }
+
+        std::string out(81, '0');
+        for (int r = 0; r < 9; ++r)
+            for (int c = 0; c < 9; ++c)
+            {
+                const char ch = puzzle[rows[r] * 9 + cols[c]];
+                if (ch >= '1' && ch <= '9')
+                    out[r * 9 + c] = char('1' + digits[ch - '1']);
+            }
+        return out;
+    }
+
+    double puzzlesPerSecond(const std::vector<std::string>& puzzles, const BatchOptions& options)
+    {
+        auto start = std::chrono::steady_clock::now();
+        solveBatch(puzzles, 9, options);
+        auto end = std::chrono::steady_clock::now();
+        return puzzles.size() / std::chrono::duration<double>(end - start).count();
+    }
+}
+
+int main(int argc, char** argv)
+{
+    std::vector<std::string> paths;
+    if (argc > 1)
+        paths.assign(argv + 1, argv + argc);
+    else
+        paths = corpusFiles("boards", { 9 });
+
+    std::vector<LaneIsa> kernels;
+    for (LaneIsa isa : { LaneIsa::Generic, LaneIsa::Avx2, LaneIsa::Avx512 })
+        if (laneIsaSupported(isa)) kernels.push_back(isa);
+
+    std::cout << std::left << std::setw(34) << "boards" << std::right << std::setw(12) << "plain";
+    for (LaneIsa isa : kernels)
+        std::cout << std::setw(12) << laneIsaName(isa);
+    std::cout << "   (puzzles/s, one thread)\n";
+
+    std::mt19937 rng(1);
+    std::vector<std::string> everything;
+    auto report = [&](const std::string& name, const std::vector<std::string>& puzzles) {
+        BatchOptions options;
+        options.threads = 1;
+        options.lockstep = false;
+        std::cout << std::left << std::setw(34) << name << std::right << std::fixed << std::setprecision(0)
+                  << std::setw(12) << puzzlesPerSecond(puzzles, options);
+        options.lockstep = true;
+        for (LaneIsa isa : kernels)
+        {
+            options.laneIsa = isa;
+            std::cout << std::setw(12) << puzzlesPerSecond(puzzles, options);
+        }
+        std::cout << "\n";
+    };
+
+    for (const std::string& path : paths)
+    {
+        std::vector<std::string> puzzles;
+        for (const std::string& puzzle : readPuzzles(path))
+            if (puzzleSize(puzzle) == 9)
+                for (int i = 0; i < variants; ++i)
+                    puzzles.push_back(shuffled(puzzle, rng));
+        if (puzzles.empty()) continue;
+
+        report(path, puzzles);
+        everything.insert(everything.end(), puzzles.begin(), puzzles.end());
+    }
+    std::shuffle(everything.begin(), everything.end(), rng);
+    if (!everything.empty())
+        report("all", everything);
+    return 0;
+}
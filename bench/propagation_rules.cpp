@@ -0,0 +1,116 @@
+// propagation_rules.cpp
+// Measures what each propagation profile buys: solves every board under boards/<n>x<n>/
+// (or the files given on the command line) with each named profile and prints the mean
+// solve time and the search nodes, then the per-stage counters of the profile with rule
+// timing on. Nodes saved against time spent is what PropagationProfile::forSize is tuned on.
+//
+// Run from the repository root:  ./bench_propagation_rules [reps] [board files...]
+
+#include "puzzles.h"
+#include "sudoku.h"
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace
+{
+    struct Result
+    {
+        double micros = 0;
+        uint64_t nodes = 0;
+        RuleStats stats;
+        bool solved = false;
+    };
+
+    Result run(int size, const std::string& puzzle, const PropagationProfile& profile, int reps)
+    {
+        SudokuBoard board(size);
+        board.setProfile(profile);
+        Result result;
+
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < reps; ++i)
+        {
+            board.load(puzzle);
+            result.solved = board.solve();
+        }
+        auto end = std::chrono::steady_clock::now();
+        result.micros = std::chrono::duration<double, std::micro>(end - start).count() / reps;
+        result.nodes = board.nodeCount();
+
+        // one more run for the stage counters, timed separately so the clock reads stay out of the mean
+        board.setRuleTiming(true);
+        board.load(puzzle);
+        board.solve();
+        result.stats = board.ruleStats();
+        return result;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    int reps = argc > 1 ? std::atoi(argv[1]) : 5;
+    if (reps <= 0) reps = 5;
+
+    std::vector<std::string> paths;
+    if (argc > 2)
+        paths.assign(argv + 2, argv + argc);
+    else
+        paths = corpusFiles("boards");
+
+    const char* profiles[] = { "singles", "basic", "subsets", "full", "default" };
+
+    std::cout << std::left << std::setw(32) << "board" << std::setw(9) << "profile"
+              << std::right << std::setw(12) << "time (us)" << std::setw(10) << "nodes" << "\n";
+
+    RuleStats totals[3]; // default profile, per board size
+    for (const std::string& path : paths)
+    {
+        for (const std::string& puzzle : readPuzzles(path))
+        {
+            const int size = puzzleSize(puzzle);
+
+            for (const char* name : profiles)
+            {
+                Result r = run(size, puzzle, *PropagationProfile::named(name, size), reps);
+                std::cout << std::left << std::setw(32) << path << std::setw(9) << name
+                          << std::right << std::fixed << std::setprecision(1)
+                          << std::setw(12) << r.micros << std::setw(10) << r.nodes
+                          << (r.solved ? "" : "  unsolved") << "\n";
+
+                if (std::string(name) == "default")
+                {
+                    RuleStats& total = totals[size == 9 ? 0 : size == 16 ? 1 : 2];
+                    for (int k = 0; k < ruleCount; ++k)
+                    {
+                        total.counters[k].runs += r.stats.counters[k].runs;
+                        total.counters[k].hits += r.stats.counters[k].hits;
+                        total.counters[k].changes += r.stats.counters[k].changes;
+                        total.counters[k].nanos += r.stats.counters[k].nanos;
+                    }
+                }
+            }
+        }
+    }
+
+    std::cout << "\nstages of the default profile\n";
+    for (int i = 0; i < 3; ++i)
+    {
+        const int size = i == 0 ? 9 : i == 1 ? 16 : 25;
+        for (int k = 0; k < ruleCount; ++k)
+        {
+            const RuleCounters& c = totals[i].counters[k];
+            if (c.runs == 0) continue;
+            std::cout << std::left << std::setw(3) << size << std::setw(16) << ruleName(Rule(k))
+                      << std::right << std::setw(10) << c.runs << " runs"
+                      << std::fixed << std::setprecision(1)
+                      << std::setw(8) << 100.0 * c.hits / c.runs << "% hits"
+                      << std::setw(10) << c.changes << " changes"
+                      << std::setw(10) << double(c.nanos) / c.runs << " ns/run\n";
+        }
+    }
+    return 0;
+}
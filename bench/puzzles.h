@@ -0,0 +1,61 @@
+#pragma once
+// puzzles.h
+// How the benches read their boards, so they all agree on what a board file holds: the same
+// characters as BasicSudokuBoard::loadFromFile, one puzzle per file or one puzzle per line.
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <initializer_list>
+#include <string>
+#include <vector>
+
+// 9, 16 or 25 for a whole board's worth of cells, otherwise 0
+inline int puzzleSize(const std::string& cells)
+{
+    for (int n : { 9, 16, 25 })
+        if ((int)cells.size() == n * n) return n;
+    return 0;
+}
+
+// One puzzle per line when every line is a whole board, otherwise the file is one board.
+// Empty or malformed files give no puzzles.
+inline std::vector<std::string> readPuzzles(const std::string& path)
+{
+    std::ifstream file(path);
+    std::vector<std::string> lines;
+    std::string whole, line;
+    bool perLine = true;
+    while (std::getline(file, line))
+    {
+        std::string cells;
+        for (char ch : line)
+            if ((ch >= '0' && ch <= '9') || (ch >= 'A' && ch <= 'Z') || (ch >= 'a' && ch <= 'z') || ch == '.')
+                cells += ch;
+        whole += cells;
+        if (cells.empty()) continue;
+        if (puzzleSize(cells) == 0) perLine = false;
+        lines.push_back(cells);
+    }
+    if (perLine && lines.size() > 1) return lines;
+    if (puzzleSize(whole) != 0) return { whole };
+    return {};
+}
+
+// The files under root/<n>x<n>/ for each size, sorted within a size
+inline std::vector<std::string> corpusFiles(const std::filesystem::path& root,
+                                            std::initializer_list<int> sizes = { 9, 16, 25 })
+{
+    std::vector<std::string> paths;
+    for (int size : sizes)
+    {
+        const std::filesystem::path dir = root / (std::to_string(size) + "x" + std::to_string(size));
+        if (!std::filesystem::is_directory(dir)) continue;
+
+        const size_t first = paths.size();
+        for (const auto& entry : std::filesystem::directory_iterator(dir))
+            paths.push_back(entry.path().string());
+        std::sort(paths.begin() + first, paths.end());
+    }
+    return paths;
+}
@@ -0,0 +1,83 @@
+// state_strategy.cpp
+// Compares the two ways backtrackingLogged can undo a failed branch: replaying the undo
+// trail versus restoring a board snapshot. Solves every board under boards/<n>x<n>/
+// (or the files given on the command line) with both strategies and prints the mean
+// solve time, so the per-size default in BasicSudokuBoard can be checked.
+//
+// Run from the repository root:  ./bench_state_strategy [reps] [board files...]
+
+#include "puzzles.h"
+#include "sudoku.h"
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace
+{
+    struct Puzzle
+    {
+        int size;
+        std::string path;
+        std::string cells; // read once, so the timed loop only loads and solves
+    };
+
+    double meanSolveMicros(const Puzzle& p, StateStrategy strategy, int reps, bool& solved)
+    {
+        SudokuBoard board(p.size);
+        board.setStateStrategy(strategy);
+
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < reps; ++i)
+        {
+            board.load(p.cells);
+            solved = board.solve();
+        }
+        auto end = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::micro>(end - start).count() / reps;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    int reps = argc > 1 ? std::atoi(argv[1]) : 20;
+    if (reps <= 0) reps = 20;
+
+    std::vector<std::string> paths;
+    if (argc > 2)
+        paths.assign(argv + 2, argv + argc);
+    else
+        paths = corpusFiles("boards");
+
+    std::vector<Puzzle> puzzles;
+    for (const std::string& path : paths)
+        for (const std::string& cells : readPuzzles(path))
+            puzzles.push_back({ puzzleSize(cells), path, cells });
+
+    std::cout << std::left << std::setw(32) << "board"
+              << std::right << std::setw(14) << "trail (us)"
+              << std::setw(16) << "snapshot (us)" << "  faster\n";
+
+    for (const Puzzle& p : puzzles)
+    {
+        try
+        {
+            bool solvedTrail = false, solvedSnap = false;
+            double trail = meanSolveMicros(p, StateStrategy::Trail, reps, solvedTrail);
+            double snap = meanSolveMicros(p, StateStrategy::Snapshot, reps, solvedSnap);
+
+            std::cout << std::left << std::setw(32) << p.path
+                      << std::right << std::fixed << std::setprecision(1)
+                      << std::setw(14) << trail << std::setw(16) << snap
+                      << "  " << (trail <= snap ? "trail" : "snapshot")
+                      << (solvedTrail == solvedSnap ? "" : "  (results differ!)") << "\n";
+        }
+        catch (const std::exception& e)
+        {
+            std::cout << std::left << std::setw(32) << p.path << "  skipped: " << e.what() << "\n";
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,96 @@
+// value_order.cpp
+// Compares the value-ordering policies of the backtracking search: solves every board under
+// boards/<n>x<n>/ (or the files given on the command line) with each ValueOrder and prints,
+// per board size, the search nodes and time summed over the boards. Random is averaged over
+// a few seeds. Each solve is capped at ten seconds; capped solves are listed as aborted.
+//
+// A board file holds one puzzle, or one puzzle per line.
+//
+// Run from the repository root:  ./bench_value_order [board files...]
+
+#include "puzzles.h"
+#include "sudoku.h"
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace
+{
+    constexpr int randomSeeds = 5;
+    constexpr auto timeCap = std::chrono::seconds(10);
+
+    struct Totals
+    {
+        int boards = 0;
+        uint64_t nodes = 0;
+        double millis = 0;
+        int aborted = 0;
+    };
+
+    void run(int size, const std::string& puzzle, ValueOrder order, uint64_t seed, Totals& totals)
+    {
+        SudokuBoard board(size);
+        board.setValueOrder(order, seed);
+        SearchLimits limits;
+        limits.maxTime = timeCap;
+
+        auto start = std::chrono::steady_clock::now();
+        board.load(puzzle);
+        SearchStatus status = board.solve(limits);
+        auto end = std::chrono::steady_clock::now();
+
+        ++totals.boards;
+        totals.nodes += board.nodeCount();
+        totals.millis += std::chrono::duration<double, std::milli>(end - start).count();
+        if (status == SearchStatus::Aborted) ++totals.aborted;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    std::vector<std::string> paths;
+    if (argc > 1)
+        paths.assign(argv + 1, argv + argc);
+    else
+        paths = corpusFiles("boards");
+
+    const ValueOrder orders[] = { ValueOrder::Ascending, ValueOrder::LeastConstraining, ValueOrder::Frequency, ValueOrder::Random };
+    std::map<int, std::map<ValueOrder, Totals>> results; // by board size
+
+    for (const std::string& path : paths)
+        for (const std::string& puzzle : readPuzzles(path))
+        {
+            const int size = puzzleSize(puzzle);
+
+            for (ValueOrder order : orders)
+            {
+                Totals& totals = results[size][order];
+                if (order != ValueOrder::Random)
+                {
+                    run(size, puzzle, order, 1, totals);
+                    continue;
+                }
+                Totals seeds;
+                for (uint64_t seed = 1; seed <= randomSeeds; ++seed)
+                    run(size, puzzle, order, seed, seeds);
+                ++totals.boards;
+                totals.nodes += seeds.nodes / randomSeeds;
+                totals.millis += seeds.millis / randomSeeds;
+                totals.aborted += seeds.aborted;
+            }
+        }
+
+    std::cout << std::left << std::setw(6) << "size" << std::setw(11) << "order"
+              << std::right << std::setw(8) << "boards" << std::setw(12) << "nodes"
+              << std::setw(12) << "time (ms)" << std::setw(9) << "aborted" << "\n";
+    for (const auto& [size, bySize] : results)
+        for (const auto& [order, t] : bySize)
+            std::cout << std::left << std::setw(6) << size << std::setw(11) << valueOrderName(order)
+                      << std::right << std::setw(8) << t.boards << std::setw(12) << t.nodes
+                      << std::fixed << std::setprecision(1) << std::setw(12) << t.millis
+                      << std::setw(9) << t.aborted << "\n";
+    return 0;
+}
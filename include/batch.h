@@ -0,0 +1,47 @@
+#pragma once
+// batch.h
+// Solves many puzzles of one size at once. Each worker thread builds one solver and reloads
+// it for every puzzle it takes, so the per-puzzle cost is a load and a search: no board,
+// trail or engine setup. Workers take puzzles in small chunks from a shared counter, and
+// results land in input order whatever thread solved them.
+//
+// 9x9 batches first go through the SIMD lanes of lockstep.h, a lane's worth of puzzles at a
+// time; only the puzzles singles cannot finish reach the solver. A puzzle with several
+// solutions may then come back with a different one than a plain solve would give.
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+#include "lockstep.h"
+#include "solver.h"
+
+struct BatchOptions
+{
+    Engine engine = Engine::Portfolio;
+    std::optional<PropagationProfile> profile; // empty: the per-size default
+    std::optional<ValueOrder> valueOrder; // empty: the per-size default
+    SearchLimits limits; // applied to each puzzle; a cancel flag stops every search left, not input checks
+    int threads = 0; // 0 = the hardware threads; at most one per chunk of puzzles
+    bool lockstep = true; // 9x9: singles in SIMD lanes before the solver
+    std::optional<LaneIsa> laneIsa; // empty: bestLaneIsa()
+};
+
+struct BatchResult
+{
+    BoardError error = BoardError::None; // not searched: bad input, or Conflict for duplicate givens
+    SearchStatus status = SearchStatus::Unsolvable;
+    std::string solution; // when Solved, see boardString
+    uint64_t nodes = 0; // 0 for puzzles the lanes finished
+};
+
+// Throws std::invalid_argument for sizes other than 9, 16 and 25, like makeSolver.
+std::vector<BatchResult> solveBatch(const std::string* puzzles, size_t count, int boardSize,
+                                    const BatchOptions& options = {});
+
+inline std::vector<BatchResult> solveBatch(const std::vector<std::string>& puzzles, int boardSize,
+                                           const BatchOptions& options = {})
+{
+    return solveBatch(puzzles.data(), puzzles.size(), boardSize, options);
+}
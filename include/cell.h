@@ -1,30 +1,32 @@
 #pragma once
 // Cell.h
 // Represents a single Sudoku cell: current value (0 = empty) and a bitmask of possibilities.
-// Uses a uint32_t mask where bit (num-1) set => number `num` is possible.
+// Templated on the board order (3, 4 or 5), so N and the mask width are compile-time
+// constants: bit (num-1) set => number `num` is possible.
+// All members are defined in this header so every elimination inlines into the solver.
 
+#include <cassert>
 #include <cstdint>
 #include <string>
+#include <type_traits>
 
-struct Change 
+template <int Order>
+class cell
 {
-    int r, c;
-    uint32_t oldPoss;
-    int oldValue;
-};
+public:
+    static constexpr int N = Order * Order; // max number (board size)
+    using mask_t = std::conditional_t<(N <= 16), uint16_t, uint32_t>; // narrowest mask holding N bits
+    static constexpr mask_t fullMask = mask_t((uint64_t(1) << N) - 1);
 
-class cell 
-{
 private:
-    int N;                  // max number (board size)
-    int cellValue;             // current value (0 = empty)
-    uint32_t possibilities; // bitmask of possible numbers
+    uint8_t cellValue;      // current value (0 = empty)
+    mask_t possibilities;   // bitmask of possible numbers
 public:
-    explicit cell(int boardSize);
+    cell();
 
     int getValue() const { return cellValue; } // get current cell value
     void setValue(int num);         // set cell to a specific value (removes all possibilities except num)
-    uint32_t getPossibilities() const { return possibilities; }
+    mask_t getPossibilities() const { return possibilities; }
 
     bool removePossibility(int num); // remove a possibility and return true if changed
     bool isPossible(int num) const; // check if num is possible
@@ -32,5 +34,86 @@ public:
     bool hasOnlyOnePossibility() const; // true if exactly one possibility remains
     int possibilityCount() const; // count of possible numbers
     int getSinglePossibility() const; // get the single possible value (assumes hasOnlyOnePossibility is true)
-    void restore(uint32_t oldPoss, int oldValue);
+    void restore(mask_t oldPoss, int oldValue);
+};
+
+template <int Order>
+cell<Order>::cell() 
+        : cellValue(0) , possibilities(fullMask)
+{
+}
+
+template <int Order>
+bool cell<Order>::removePossibility(int num) 
+{
+    assert(num >= 1 && num <= N); // callers validate once at the load boundary
+
+    if (cellValue != 0) 
+        return false; // fixed cells should not lose possibilities
+
+    if(!isPossible(num))
+        return false; // if the number is not possible, return false as it will not change anything
+
+    possibilities &= mask_t(~(1u << (num - 1)));
+    return true;
+}
+
+template <int Order>
+bool cell<Order>::isPossible(int num) const 
+{
+    assert(num >= 1 && num <= N);
+    return possibilities & (1u << (num - 1));
+}
+
+template <int Order>
+void cell<Order>::clear() 
+{
+    possibilities = fullMask;
+    cellValue = 0;
+}
+
+template <int Order>
+void cell<Order>::setValue(int num) 
+{
+    assert(num >= 1 && num <= N);
+    possibilities = mask_t(1u << (num - 1));
+    cellValue = uint8_t(num);
+}
+
+template <int Order>
+bool cell<Order>::hasOnlyOnePossibility() const 
+{
+    return __builtin_popcount(possibilities) == 1;
+}
+
+template <int Order>
+int cell<Order>::possibilityCount() const 
+{
+    return __builtin_popcount(possibilities);
+}
+
+template <int Order>
+int cell<Order>::getSinglePossibility() const
+{
+    // __builtin_ffs returns 1-indexed position of the first set bit
+    // Since we store bit (num-1) for value num, this gives us the value directly
+    return __builtin_ffs(possibilities);
+}
+
+template <int Order>
+void cell<Order>::restore(mask_t oldPoss, int oldValue)
+{
+    possibilities = oldPoss;
+    cellValue = uint8_t(oldValue);
+}
+
+// One undo record: the cell id, with the high bit set when the record undoes an
+// assignment, and the cell's mask before the change. 4 bytes for 9x9/16x16, 8 for 25x25.
+template <int Order>
+struct Change
+{
+    static constexpr uint16_t assignedFlag = 0x8000;
+
+    uint16_t id;
+    typename cell<Order>::mask_t oldPoss;
 };
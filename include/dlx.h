@@ -0,0 +1,65 @@
+#pragma once
+// dlx.h
+// Exact-cover engine: Knuth's Algorithm X on dancing links.
+//
+// A board of size n becomes 4 * n^2 constraint columns (each cell filled once, each number
+// once per row, per column and per box) and n^3 candidate rows (number v in cell (r, c)) of
+// four nodes each. Every node lives in one arena allocated by the constructor; loading and
+// solving only relink it. Columns are picked by smallest size, which also makes counting
+// solutions cheap.
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "solver.h"
+
+class DlxSolver : public SudokuSolver
+{
+public:
+    explicit DlxSolver(int boardSize);
+
+    int size() const override { return n; }
+    BoardError load(const std::string& puzzle) override;
+    bool isConsistent() const override { return consistent; }
+    SearchStatus solve(const SearchLimits& limits = {}) override;
+    int getValue(int row, int col) const override { return values[row * n + col]; }
+    uint64_t nodeCount() const override { return nodes; }
+    using SudokuSolver::countSolutions;
+    SolutionCount countSolutions(uint64_t limit, const SearchLimits& limits) override;
+
+private:
+    int n; // board size
+    int box; // box size, sqrt(n)
+    int columns; // 4 * n^2 constraint columns, headers 1..columns; 0 is the root
+
+    // Node arena, structure of arrays. Column headers double as the top/bottom of their column.
+    std::vector<int> left, right, up, down;
+    std::vector<int> column; // header of a node's column
+    std::vector<int> candidate; // (cell * n + value - 1) of a row node
+    std::vector<int> columnSize; // rows left in each column
+
+    std::vector<uint8_t> givens; // loaded puzzle, 0 = empty
+    std::vector<uint8_t> values; // givens plus the rows picked by the search
+    bool consistent = true;
+
+    // Explicit search stack: one covered column per level and the row tried in it
+    // (the column header itself before the first row).
+    struct Level
+    {
+        int col;
+        int row;
+    };
+    std::vector<Level> levels;
+    bool descend = false; // next step opens a level rather than advancing the top one
+    bool searching = false; // a search is open: aborted, or stopped at a solution while counting
+    uint64_t nodes = 0;
+
+    void reset(); // relink every node and cover the givens
+    void cover(int col);
+    void uncover(int col);
+    void select(int row); // cover the other columns of a chosen row
+    void unselect(int row);
+    int chooseColumn() const; // smallest column
+    SearchStatus run(const SearchLimits& limits); // step the search until a solution, exhaustion or a limit
+    void recordSolution();
+};
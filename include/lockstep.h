@@ -0,0 +1,35 @@
+#pragma once
+// lockstep.h
+// Singles propagation on many 9x9 puzzles at once. Each puzzle gets one lane of a SIMD vector:
+// a cell is one vector of candidate masks, so a single bitwise instruction updates that cell in
+// every puzzle. Most 9x9 puzzles of a bulk set fall to naked and hidden singles alone; the ones
+// that get stuck go on to the normal search from where the lanes left them.
+//
+// The kernel is built for each instruction set the compiler can target and picked at run time:
+//   Generic - portable vector code for the baseline target, 8 lanes in 128 bits (SSE2 on x86-64)
+//   Avx2    - 16 lanes in one 256-bit register
+//   Avx512  - 32 lanes in one 512-bit register (AVX-512BW)
+
+#include <cstdint>
+#include <optional>
+#include <string>
+
+enum class LaneIsa { Generic, Avx2, Avx512 };
+
+constexpr int maxLanes = 32;
+
+LaneIsa bestLaneIsa(); // the widest kernel this build has and this CPU runs
+bool laneIsaSupported(LaneIsa isa);
+int laneCount(LaneIsa isa);
+const char* laneIsaName(LaneIsa isa); // "generic", "avx2" or "avx512"
+std::optional<LaneIsa> laneIsaFromName(const std::string& name);
+
+// A puzzle the lanes take as is: 81 cells of '0'..'9' or '.', with no duplicate givens.
+// Anything else goes through SudokuSolver::load, which reports what is wrong with it.
+bool laneReady(const std::string& puzzle);
+
+// Runs singles on up to laneCount(isa) laneReady puzzles, one per lane, and writes back the grid
+// each one reached, with '0' for the cells still open: none when the lane solved its puzzle.
+// Returns the lanes that hit a contradiction (bit l for puzzles[l]); their grids are undefined.
+// An unsupported isa falls back to bestLaneIsa().
+uint32_t propagateLanes(std::string* puzzles, int count, LaneIsa isa = bestLaneIsa());
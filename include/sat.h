@@ -0,0 +1,135 @@
+#pragma once
+// sat.h
+// Conflict-driven clause learning (CDCL) SAT solver, and a Sudoku engine on top of it.
+//
+// Chronological backtracking has no memory: on a minimal or subtly unsolvable 25x25 board it
+// can fail the same way in many subtrees. A CDCL search learns a clause from every conflict
+// and jumps straight back to the decision that caused it, so those boards stay tractable.
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "solver.h"
+
+// Plain CNF solver. Literals are 2 * var + 1 for the negation, 2 * var otherwise.
+//   - two watched literals per clause; binary clauses are resolved from the watch alone
+//   - first-UIP learning with clause minimization
+//   - VSIDS branching with phase saving, Luby restarts
+//   - learnt clauses ranked by LBD (distinct decision levels), the worse half dropped periodically
+class CdclSolver
+{
+public:
+    static int literal(int var, bool negated) { return 2 * var + (negated ? 1 : 0); }
+
+    int newVar();
+    int varCount() const { return (int)assigns.size(); }
+    bool addClause(std::vector<int> lits); // false once the formula is known to be unsatisfiable
+    SearchStatus solve(const SearchLimits& limits = {}); // resumes an aborted solve
+    bool modelValue(int var) const { return model[var]; } // after Solved
+
+    uint64_t decisionCount() const { return decisions; }
+    uint64_t conflictCount() const { return conflicts; }
+
+private:
+    static constexpr uint32_t noReason = UINT32_MAX;
+    static constexpr uint32_t binaryFlag = 1u << 31; // watch of a two-literal clause
+
+    // Clause arena: [size][flags: learnt, deleted, lbd << 2][literals...], referenced by offset
+    std::vector<uint32_t> arena;
+    std::vector<uint32_t> learnts;
+    uint32_t clauseSize(uint32_t cref) const { return arena[cref]; }
+    uint32_t* clauseLits(uint32_t cref) { return &arena[cref + 2]; }
+    bool isLearnt(uint32_t cref) const { return arena[cref + 1] & 1; }
+    bool isDeleted(uint32_t cref) const { return arena[cref + 1] & 2; }
+    uint32_t lbd(uint32_t cref) const { return arena[cref + 1] >> 2; }
+
+    struct Watch
+    {
+        uint32_t cref; // | binaryFlag for two-literal clauses
+        int blocker; // a literal of the clause; the clause is skipped while it is true
+    };
+    std::vector<std::vector<Watch>> watches; // by literal, visited when it becomes false
+
+    std::vector<int8_t> assigns; // per variable: 1 true, 0 false, -1 unassigned
+    std::vector<int> level;
+    std::vector<uint32_t> reason;
+    std::vector<int> trail;
+    std::vector<int> trailLim; // trail size at each decision
+    size_t qhead = 0;
+    bool unsat = false;
+
+    // VSIDS: a binary max-heap of unassigned variables by activity
+    std::vector<double> activity;
+    double varInc = 1.0;
+    std::vector<int> heap;
+    std::vector<int> heapPos; // -1 when not in the heap
+    std::vector<bool> phase; // last value of each variable, reused at the next decision
+
+    std::vector<bool> model;
+    std::vector<uint8_t> seen; // analysis scratch
+    std::vector<uint32_t> levelStamp; // LBD scratch
+    uint32_t stamp = 0;
+    std::vector<int> learnt;
+    std::vector<int> toClear; // literals whose `seen` mark analysis must reset
+
+    uint64_t decisions = 0;
+    uint64_t conflicts = 0;
+    uint64_t restartConflicts = 0; // conflicts since the last restart
+    uint64_t restartLimit = 0;
+    int restarts = 0;
+    uint64_t nextReduce = 2000; // conflicts at the next learnt clause cleanup
+    int reductions = 0;
+
+    int value(int lit) const
+    {
+        const int a = assigns[lit >> 1];
+        return a < 0 ? -1 : a ^ (lit & 1);
+    }
+    int decisionLevel() const { return (int)trailLim.size(); }
+
+    uint32_t allocClause(const std::vector<int>& lits, bool isLearntClause, uint32_t clauseLbd);
+    void attach(uint32_t cref);
+    void enqueue(int lit, uint32_t from);
+    uint32_t propagate(); // conflicting clause, or noReason
+    void analyze(uint32_t confl, int& backLevel, uint32_t& clauseLbd);
+    bool redundant(int lit); // implied by the other literals of the learnt clause
+    void cancelUntil(int lvl);
+    void reduceLearnts();
+    void bumpVar(int var);
+    void heapUp(int pos);
+    void heapDown(int pos);
+    void heapInsert(int var);
+    int heapPop();
+    int pickBranchVar(); // -1 when every variable is assigned
+};
+
+// Sudoku through CdclSolver. The puzzle is loaded and propagated on a SudokuBoard first, so
+// only the candidates left after propagation become variables (one per cell-digit pair):
+// at least and at most one digit per cell, and one place per digit in every unit.
+class SatSudokuSolver : public SudokuSolver
+{
+public:
+    explicit SatSudokuSolver(int boardSize);
+
+    int size() const override { return n; }
+    BoardError load(const std::string& puzzle) override;
+    bool isConsistent() const override { return board.isConsistent(); }
+    SearchStatus solve(const SearchLimits& limits = {}) override;
+    int getValue(int row, int col) const override { return values[row * n + col]; }
+    uint64_t nodeCount() const override { return sat ? sat->decisionCount() : 0; }
+    using SudokuSolver::countSolutions;
+    SolutionCount countSolutions(uint64_t limit, const SearchLimits& limits) override;
+    void setProfile(const PropagationProfile& p) override { board.setProfile(p); }
+
+private:
+    int n;
+    SudokuBoard board; // validation and propagation before encoding
+    std::unique_ptr<CdclSolver> sat;
+    std::vector<int> varCell, varValue; // decoding of each variable
+    std::vector<uint8_t> values;
+    bool searching = false; // an aborted solve is waiting to be resumed
+
+    bool encode(); // build the CNF; false if propagation already found a contradiction
+    void readModel();
+};
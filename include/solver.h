@@ -0,0 +1,70 @@
+#pragma once
+// solver.h
+// Common interface over the solving engines, so callers such as the HTTP server can route a
+// puzzle to either of them:
+//   Propagation - SudokuBoard: constraint propagation plus MRV backtracking (sudoku.h)
+//   Dlx         - DlxSolver: exact cover with Knuth's dancing links (dlx.h)
+//   Sat         - SatSudokuSolver: CDCL SAT search with clause learning (sat.h)
+//   Portfolio   - propagation first, handed over to the SAT engine once its search runs past
+//                 a node budget (defaultEscalationNodes)
+//   Race        - differently configured propagation searches on separate threads, the first
+//                 answer wins (raceAfterNodes)
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include "sudoku.h"
+
+enum class Engine { Propagation, Dlx, Sat, Portfolio, Race };
+
+std::optional<Engine> engineFromName(const std::string& name); // "propagation", "dlx", "sat", "portfolio" or "race"
+const char* engineName(Engine engine);
+
+class SudokuSolver
+{
+public:
+    virtual ~SudokuSolver() = default;
+
+    virtual int size() const = 0; // board size (9, 16 or 25)
+    virtual BoardError load(const std::string& puzzle) = 0; // duplicate givens load but cannot be solved
+    virtual bool isConsistent() const = 0; // no duplicate givens
+    virtual SearchStatus solve(const SearchLimits& limits = {}) = 0; // resumes an aborted solve
+    virtual int getValue(int row, int col) const = 0; // 0 = empty, unchecked
+    virtual uint64_t nodeCount() const = 0; // branches tried by the last search
+
+    // Number of solutions of the loaded puzzle, stopping at `limit`. Leaves the board on the
+    // last solution found (or wherever the search ended); load again before solving.
+    uint64_t countSolutions(uint64_t limit) { return countSolutions(limit, SearchLimits{}).count; }
+
+    // The same, bounded: `limits` cover the whole count, and a count they stop is incomplete
+    virtual SolutionCount countSolutions(uint64_t limit, const SearchLimits& limits) = 0;
+
+    // Propagation stages to use; engines without a propagation pipeline ignore it
+    virtual void setProfile(const PropagationProfile&) {}
+
+    // Order the backtracking search tries a cell's candidates in; other engines ignore it
+    virtual void setValueOrder(ValueOrder) {}
+
+    // Threads for one solve (work-stealing parallel search); engines without it stay serial
+    virtual void setThreads(int) {}
+};
+
+// The solver's board as a puzzle string: '0' for empty cells, then '1'..'9', 'A'..
+std::string boardString(const SudokuSolver& solver);
+
+// Search nodes the portfolio gives the propagation engine before escalating to SAT. Boards
+// that need more are the ones where chronological backtracking keeps failing the same way.
+// On 25x25 the SAT engine wins as soon as a search is more than trivial; on smaller boards
+// the budget barely matters, as both engines finish in milliseconds. With setThreads above 1
+// the propagation stage gets parallelAfterNodes (sudoku.h) on the calling thread plus the
+// budget for each thread, so its parallel search starts before the escalation at every size.
+constexpr uint64_t defaultEscalationNodes(int boardSize) { return boardSize == 25 ? 500 : 2000; }
+
+// Search nodes the Race engine's first configuration gets on the calling thread before the
+// others start, so boards that need little search never start threads.
+constexpr uint64_t raceAfterNodes = 1000;
+
+// Throws std::invalid_argument for sizes other than 9, 16 and 25, like SudokuBoard.
+// escalationNodes is the Portfolio budget, 0 for defaultEscalationNodes(boardSize).
+std::unique_ptr<SudokuSolver> makeSolver(Engine engine, int boardSize, uint64_t escalationNodes = 0);
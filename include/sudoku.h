@@ -2,43 +2,429 @@
 // SudokuBoard.h
 // High-level board class that holds Cell objects and performs constraint propagation
 // and auto-filling of single-candidate cells.
+//
+// BasicSudokuBoard<Order> is the solver proper, specialized at compile time for boxes
+// of Order x Order (3 => 9x9, 4 => 16x16, 5 => 25x25). SudokuBoard picks the right
+// specialization from a runtime size, for callers such as the HTTP server.
 
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
 #include <vector>
 #include <string>
 #include <optional>
+#include <variant>
 #include <cstdint>
 #include "cell.h"
 
-class SudokuBoard 
+// Compile-time unit tables: which cells belong to each row, column and box,
+// and which units each cell belongs to.
+template <int Order>
+struct BoardGeometry
 {
+    static constexpr int N = Order * Order;
+    static constexpr int NN = N * N;
+
+    std::array<std::array<int16_t, N>, N> rowCells{};
+    std::array<std::array<int16_t, N>, N> colCells{};
+    std::array<std::array<int16_t, N>, N> boxCells{};
+    std::array<uint8_t, NN> rowOf{};
+    std::array<uint8_t, NN> colOf{};
+    std::array<uint8_t, NN> boxOf{};
+    std::array<uint8_t, NN> boxPosOf{}; // position of a cell inside its box
+    std::array<std::array<int16_t, N>, 3 * N> unitCells{}; // rows, then columns, then boxes
+
+    // Position masks inside a unit. bandMask[k] selects positions k*Order .. k*Order+Order-1
+    // (in a row: the cells of box-column k; in a box: box-row k). stackMask[k] selects
+    // positions p with p % Order == k (in a box: box-column k).
+    std::array<uint32_t, Order> bandMask{};
+    std::array<uint32_t, Order> stackMask{};
+
+    constexpr BoardGeometry()
+    {
+        for (int r = 0; r < N; ++r)
+            for (int c = 0; c < N; ++c)
+            {
+                int id = r * N + c;
+                int b = (r / Order) * Order + c / Order;
+                int pos = (r % Order) * Order + c % Order;
+                rowCells[r][c] = int16_t(id);
+                colCells[c][r] = int16_t(id);
+                boxCells[b][pos] = int16_t(id);
+                rowOf[id] = uint8_t(r);
+                colOf[id] = uint8_t(c);
+                boxOf[id] = uint8_t(b);
+                boxPosOf[id] = uint8_t(pos);
+                unitCells[r][c] = int16_t(id);
+                unitCells[N + c][r] = int16_t(id);
+                unitCells[2 * N + b][pos] = int16_t(id);
+            }
+
+        for (int p = 0; p < N; ++p)
+        {
+            bandMask[p / Order] |= 1u << p;
+            stackMask[p % Order] |= 1u << p;
+        }
+    }
+};
+
+// How the search undoes a failed branch: replay the undo trail back to a checkpoint, or
+// restore a copy of the board taken before the branch. Copying wins while the board
+// state is small; see bench/state_strategy.cpp for the crossover.
+enum class StateStrategy { Trail, Snapshot };
+
+// Order in which the search tries the candidates of its branching cell.
+// - Ascending: 1..N.
+// - LeastConstraining: the number with the fewest places left in the cell's row, column and
+//   box first, so the guess takes the fewest candidates away from its peers.
+// - Frequency: the number already placed most often on the board first.
+// - Random: a random order at every node, reproducible from the seed.
+enum class ValueOrder { Ascending, LeastConstraining, Frequency, Random };
+
+const char* valueOrderName(ValueOrder order);
+std::optional<ValueOrder> valueOrderFromName(const std::string& name); // "ascending", "lcv", "frequency" or "random"
+
+// Why untrusted input was rejected. Input is validated once, at load time or through the
+// checked setters; the solver internals below that boundary do no range checking.
+enum class BoardError { None, BadLength, BadCharacter, ValueOutOfRange, BadCoordinates, Conflict };
+
+const char* boardErrorMessage(BoardError error);
+
+// Deduction stages of the propagation pipeline.
+// - Intersections: pointing (a number confined to one line of a box leaves the rest of the line)
+//   and claiming (confined to one box of a line, it leaves the rest of the box).
+// - NakedSubsets: k cells of a unit whose candidates together are only k numbers.
+// - HiddenSubsets: k numbers that together fit only in k cells of a unit.
+// - Fish: k rows whose places for a number lie in only k columns, or the other way round
+//   (X-Wing, Swordfish, Jellyfish).
+enum class Rule { NakedSingles, HiddenSingles, Intersections, NakedSubsets, HiddenSubsets, Fish };
+constexpr int ruleCount = 6;
+
+const char* ruleName(Rule rule);
+
+// An ordered list of deduction stages. Propagation always works on the first stage that has
+// pending work, so a stage only sees the board once every stage before it is at a fixpoint.
+// Cheap, high-yield stages belong first; rules left out of the list never run.
+struct PropagationProfile
+{
+    std::array<Rule, ruleCount> stages{};
+    int stageCount = 0;
+    int maxSubset = 4; // subset sizes tried: 2 .. maxSubset (at most 4)
+    int maxFish = 3; // fish sizes tried: 2 .. maxFish (at most 4)
+    int fishBudget = 4096; // fish combinations one propagation call may try
+
+    // Inside the search, nodes at depth fullDepth and below run the stages after the two
+    // singles stages only where they have been paying off: a stage stays on at a depth while
+    // at least minHitRate of its runs at that depth change the board. It is still probed
+    // now and then so a stage that starts paying off again gets switched back on.
+    bool adaptiveDepth = true;
+    int fullDepth = 8;
+    double minHitRate = 0.02;
+
+    bool uses(Rule rule) const;
+    PropagationProfile& add(Rule rule) { stages[stageCount++] = rule; return *this; }
+
+    static PropagationProfile forSize(int boardSize); // tuned default for 9, 16 or 25
+    // "default" (forSize), "singles", "basic" (singles and intersections), "subsets" or "full"
+    static std::optional<PropagationProfile> named(const std::string& name, int boardSize);
+};
+
+// Per-stage counters since the board was last loaded or cleared. A run is one unit of work
+// (a queued cell, unit or number); a hit is a run that changed the board.
+struct RuleCounters
+{
+    uint64_t runs = 0;
+    uint64_t hits = 0;
+    uint64_t changes = 0; // candidates removed and cells placed
+    uint64_t nanos = 0; // time spent, only measured while rule timing is on
+};
+
+struct RuleStats
+{
+    std::array<RuleCounters, ruleCount> counters;
+
+    const RuleCounters& operator[](Rule rule) const { return counters[int(rule)]; }
+    RuleCounters& operator[](Rule rule) { return counters[int(rule)]; }
+};
+
+// Outcome of a bounded search. Aborted searches keep their state and resume on the next call.
+enum class SearchStatus { Solved, Unsolvable, Aborted };
+
+// Limits for one search call; zero means unlimited.
+struct SearchLimits
+{
+    uint64_t maxNodes = 0; // branches tried during this call
+    std::chrono::steady_clock::duration maxTime{0};
+    const std::atomic<bool>* cancel = nullptr; // cooperative abort, polled once per node
+};
+
+// Outcome of a bounded countSolutions
+struct SolutionCount
+{
+    uint64_t count = 0;
+    bool complete = true; // false: a limit stopped the count, so `count` is only a lower bound
+};
+
+// What is left of `limits` for the next search call of an operation that started at `start`
+// and has used `nodesUsed` nodes so far; false once a node or time limit is spent.
+inline bool remainingLimits(const SearchLimits& limits, std::chrono::steady_clock::time_point start,
+                            uint64_t nodesUsed, SearchLimits& rest)
+{
+    rest = limits;
+    if (limits.maxNodes)
+    {
+        if (nodesUsed >= limits.maxNodes) return false;
+        rest.maxNodes = limits.maxNodes - nodesUsed;
+    }
+    if (limits.maxTime.count() > 0)
+    {
+        rest.maxTime = limits.maxTime - (std::chrono::steady_clock::now() - start);
+        if (rest.maxTime.count() <= 0) return false;
+    }
+    return true;
+}
+
+template <int Order>
+class BasicSudokuBoard
+{
+public:
+    static constexpr int N = Order * Order; // board size (e.g., 9 for 9x9)
+    static constexpr int NN = N * N;
+    using cell_t = cell<Order>;
+    using mask_t = typename cell_t::mask_t;
+    static constexpr BoardGeometry<Order> geometry{};
+    // bench_state_strategy: snapshots measured faster at every size on search-heavy boards
+    // (9x9 ~13%, 16x16 ~5%, 25x25 ~14%), even though a 25x25 snapshot is ~15 KB.
+    static constexpr StateStrategy defaultStrategy = StateStrategy::Snapshot;
+    // bench_value_order: least-constraining-value cut 16x16 search nodes to about a third; on
+    // 9x9 and 25x25 no ordering beat ascending
+    static constexpr ValueOrder defaultValueOrder = Order == 4 ? ValueOrder::LeastConstraining : ValueOrder::Ascending;
+    // Unit splits only win when the MRV cell has three or more candidates left, which is rare
+    // once singles have run. They saved ~7% of the nodes on unsolvable 25x25 boards and cost
+    // nodes on 9x9, where the singles-only profile leaves wider cells.
+    static constexpr bool defaultUnitBranching = Order == 5;
+    // With setThreads above 1, a solve runs this many nodes on the calling thread before
+    // starting the parallel search, so puzzles that need little search never start threads.
+    static constexpr uint64_t parallelAfterNodes = 1000;
+
 private:
-    int N; // board size (e.g., 9 for 9x9)
-    std::vector<std::vector<cell>> grid; // 2D grid of Cells
-    std::vector<Change> log;
+    static constexpr int bucketWords = (NN + 63) / 64;
+
+    // Everything a search branch modifies. A snapshot is a plain copy of this struct.
+    struct State
+    {
+        alignas(64) std::array<cell_t, NN> grid; // flat row-major grid of Cells, cache-line aligned
+
+        // unitPos[unit][num - 1]: bit p is set when the p-th cell of the unit is empty and can still
+        // hold num. Units are rows 0..N-1, columns N..2N-1 and boxes 2N..3N-1.
+        std::array<std::array<mask_t, N>, 3 * N> unitPos;
+        std::array<mask_t, 3 * N> unitDigits; // numbers already placed in each unit
+
+        // MRV buckets: buckets[k] has bit id set when cell id is empty with exactly k candidates.
+        // bucketSize and countsPresent (bit k set <=> bucket k is non-empty) make the
+        // smallest non-empty bucket a single ctz away.
+        std::array<std::array<uint64_t, bucketWords>, N + 1> buckets;
+        std::array<int16_t, N + 1> bucketSize;
+        uint32_t countsPresent;
+    };
+    State state;
+
+    // Undo trail, preallocated for the worst case: along one search path a cell can lose at
+    // most N candidates and be assigned once, so NN * (N + 1) entries always suffice.
+    static constexpr int trailCapacity = NN * (N + 1);
+    std::vector<Change<Order>> trail;
+    int trailTop = 0;
+
+    // Snapshot stack for StateStrategy::Snapshot, one State per open branch; grown on first use
+    StateStrategy strategy = defaultStrategy;
+    std::vector<State> snapshots;
+
+    // Explicit decision stack of the iterative search. Each frame is one split - the candidates
+    // of a cell, or the places left for a number in a unit - with the alternatives not tried
+    // there yet, and where to undo to before trying the next one.
+    struct Frame
+    {
+        int16_t cell; // the branching cell; for a unit split, the cell of the place being tried
+        int16_t unit; // -1 for a cell split
+        uint8_t num; // the number placed by a unit split
+        bool dirty; // an alternative has been tried since the frame's base state
+        mask_t untried; // digits of a cell split, positions of a unit split
+        int mark; // trail checkpoint (StateStrategy::Trail)
+        uint64_t conflicts; // backjumping: decision levels behind the digits failed so far
+    };
+    std::vector<Frame> frames;
+    ValueOrder valueOrder = defaultValueOrder;
+    bool unitBranching = defaultUnitBranching;
+    uint64_t seed = 1;
+    uint64_t random = 0; // xorshift state of ValueOrder::Random, reset from `seed` by every fresh search
+    bool searching = false; // an aborted search is waiting to be resumed
+    int threads = 1; // workers of solve(); see solveParallel
+    uint64_t nodes = 0; // branches tried by the current search
+
+    // Propagation worklist: cells that dropped to a single candidate, and per unit-level stage
+    // the units whose position masks changed since that stage last examined them.
+    static constexpr int unitWords = (3 * N + 63) / 64;
+    using UnitSet = std::array<uint64_t, unitWords>;
+    std::array<int16_t, NN> singleQueue;
+    int singleHead = 0, singleTail = 0;
+    std::array<UnitSet, ruleCount> pendingUnits{}; // indexed by Rule
+    mask_t fishDigits = 0; // numbers whose positions changed since fish last looked at them
+    int fishBudget = 0; // fish combinations left in this propagation call
+    bool contradiction = false; // set the moment a cell or a unit runs out of candidates
+
+    PropagationProfile profile;
+    uint32_t unitStages = 0; // bit r set: Rule r is in the profile and works on units
+    RuleStats stats;
+    bool timeRules = false;
+    uint64_t changes = 0; // candidates removed and cells placed, for the stage counters
+
+    // Search-time payoff of each stage per depth band (4 levels each, the last one open-ended),
+    // driving which stages run at a node (PropagationProfile::adaptiveDepth).
+    struct Payoff
+    {
+        uint32_t runs;
+        uint32_t hits;
+    };
+    static constexpr int depthBands = 16;
+    std::array<std::array<Payoff, ruleCount>, depthBands> payoff{};
+    int payoffBand = -1; // band of the node being propagated, -1 outside the search
+    uint32_t activeStages = ~0u; // bit r clear: Rule r is skipped by this propagation
+
+    // Conflict-directed backjumping (setBackjumping). Every change made during the search carries
+    // the decision levels it follows from, as a bit set (bit k: the digit tried by frame k - 1;
+    // levels from 63 on share bit 63), merged per cell: why[id] covers all of a cell's
+    // eliminations, or the reason for its value. The explanations are coarse - a unit rule blames
+    // every cell of its unit - but never miss a level, so jumping over a decision is always safe.
+    bool backjumping = false; // option
+    bool explain = false; // tracking is on for the running search
+    uint64_t cause = 0; // levels behind the change being made now
+    uint64_t conflictWhy = 0; // levels behind the contradiction, once one is found
+    std::array<uint64_t, NN> why{};
+    std::vector<uint64_t> whyTrail; // why[id] before each trail entry (StateStrategy::Trail)
+    std::vector<std::array<uint64_t, NN>> whySnapshots; // why[] per frame (StateStrategy::Snapshot)
+
+    // Nogood cache: decisions found jointly inconsistent when a frame ran out of digits, checked
+    // before each branch. A ring of nogoodCapacity entries, indexed by (cell, number).
+    static constexpr int maxNogoodSize = 8;
+    static constexpr int nogoodCapacity = 1024;
+    struct Nogood
+    {
+        std::array<int16_t, maxNogoodSize> cells;
+        std::array<uint8_t, maxNogoodSize> nums;
+        int size;
+    };
+    std::vector<Nogood> nogoods;
+    int nogoodNext = 0;
+    std::vector<std::vector<int16_t>> nogoodIndex; // cell * N + num - 1 -> slots
+
+    static constexpr int idx(int row, int col) { return row * N + col; } // cell id inside the flat grid
+    static constexpr int rowUnit(int row) { return row; }
+    static constexpr int colUnit(int col) { return N + col; }
+    static constexpr int boxUnit(int box) { return 2 * N + box; }
+
+    // candidates of a cell as seen by the unit masks (solved cells contribute nothing)
+    mask_t candidates(int id) const { return state.grid[id].getValue() == 0 ? state.grid[id].getPossibilities() : 0; }
+    void updateUnits(int id, mask_t oldCand, mask_t newCand); // sync unitPos after a cell changed
+    bool eliminate(int id, int num); // remove num from a cell, keeping unitPos in sync
+    void record(int id, bool assignment) // push an undo entry for a cell about to change
+    {
+        if (explain) whyTrail[trailTop] = why[id];
+        trail[trailTop++] = { uint16_t(id | (assignment ? Change<Order>::assignedFlag : 0)), state.grid[id].getPossibilities() };
+    }
+    void place(int id, int num); // set a cell's value, keeping unitPos in sync
+    void bucketInsert(int id, int count); // add an empty cell to MRV bucket `count`
+    void bucketErase(int id, int count); // remove a cell from MRV bucket `count`
+    void markUnit(int unit); // queue a unit for re-examination
+    void clearQueues(); // drop pending propagation work
+    void restoreSnapshot(int level); // return to the state saved before branching at `level`
+    int chooseBranchCell() const; // MRV: empty cell with the fewest candidates, -1 if none (O(1) via buckets)
+    bool chooseBranchUnit(int limit, int& unit, int& num) const; // a number with fewer than `limit` places in some unit
+    bool openFrame(); // push a decision frame on the smallest split; false if the board is full
+    int nextDigit(int id, mask_t untried); // the untried number to branch on next, per valueOrder
+    void chooseStages(int level); // set activeStages for a node at `level` from the payoff so far
+    static uint64_t levelBit(int level) { return uint64_t(1) << (level < 63 ? level : 63); }
+    uint64_t explainUnit(int unit) const; // levels behind everything in a unit
+    void fail(uint64_t levels) // flag a contradiction and, when tracking, what it depends on
+    {
+        if (explain && !contradiction) conflictWhy = levels;
+        contradiction = true;
+    }
+    // Parallel search. A subtree is the path of decisions leading to it from the propagated root board.
+    struct Decision
+    {
+        int16_t cell;
+        uint8_t num;
+    };
+    struct ParallelRest; // what an aborted parallel solve left, see solveParallel
+    std::shared_ptr<ParallelRest> parallelRest; // resumed by the next solve()
+    SearchStatus solveParallel(const SearchLimits& limits);
+    // give away an untried alternative of the shallowest open frame, on a board `base` led to
+    bool splitOff(const std::vector<Decision>& base, std::vector<Decision>& path);
+    bool applyDecisions(const std::vector<Decision>& path); // place and propagate; false on contradiction
+    bool backjump(uint64_t conflicts); // leave an exhausted frame; false when the search space is empty
+    bool nogoodBlocks(int id, int num); // a cached nogood rules num out here; adds its levels to the frame
+    void learnNogood(uint64_t levels);
+    template <bool Logged>
+    bool runQueue(); // drain the worklist; false on contradiction
+    template <bool Logged>
+    bool runStage(Rule rule); // one unit of work for a stage; false if it had none
+    int popUnit(Rule rule); // next pending unit of a unit-level stage, -1 if none
+    template <bool Logged>
+    bool removeCandidate(int id, int num); // eliminate, through the trail when Logged
+    template <bool Logged>
+    bool nakedSubsets(int unit);
+    template <bool Logged>
+    bool hiddenSubsets(int unit);
+    template <bool Logged>
+    bool fish(int num);
 public:
-    explicit SudokuBoard(int boardSize);
-    
-    int charToValue(char ch);
+    BasicSudokuBoard();
+
+    static int charToValue(char ch); // -1 for characters that are not a cell value
+    BoardError load(const std::string& puzzle); // checked load; duplicate givens load but cannot be solved
     bool loadFromString(const std::string& puzzle); // load puzzle from string
     bool loadFromFile(const std::string& filename); // load puzzle from file
     void print() const; // print the board to console
     void clear(); // clear the board
     bool isSolved() const; // check if the board is completely solved
     bool isConsistent() const; // check if the current board state is valid
-    int boxSize() const; // get the size of the boxes (e.g., 3 for 9x9)
-    
-    // Cell accessor for API
-    const cell& getCell(int row, int col) const { return grid[row][col]; }
-    
+    static constexpr int boxSize() { return Order; } // get the size of the boxes (e.g., 3 for 9x9)
+
+    // Checked API for untrusted callers
+    BoardError trySetValue(int row, int col, int num); // place num if it is still a candidate
+    int getValueChecked(int row, int col) const; // -1 for out-of-range coordinates
+
+    // Cell accessor for API (unchecked)
+    const cell_t& getCell(int row, int col) const { return state.grid[idx(row, col)]; }
+    mask_t unitPositions(int unit, int num) const { return state.unitPos[unit][num - 1]; }
+
     // logging functions
     bool removePossibilityLogged(int r, int c, int num);
     void assign(int r, int c, int num);
+    int checkpoint() const { return trailTop; } // O(1) mark to roll back to
+    void setStateStrategy(StateStrategy s) { strategy = s; }
+    void setBackjumping(bool on) { backjumping = on; } // takes effect at the next fresh search
+    bool getBackjumping() const { return backjumping; }
+    void setValueOrder(ValueOrder order, uint64_t randomSeed = 1) { valueOrder = order; seed = randomSeed; } // at the next fresh search
+    ValueOrder getValueOrder() const { return valueOrder; }
+    void setUnitBranching(bool on) { unitBranching = on; } // also split on a number's places in a unit
+    void setThreads(int count) { threads = count < 1 ? 1 : count; } // parallel solve with more than one
+    int getThreads() const { return threads; }
+    bool getUnitBranching() const { return unitBranching; }
+    StateStrategy getStateStrategy() const { return strategy; }
     void rollback(int checkpoint);
     bool removeAllLogged(int row, int col, int num);
     bool propagateAllLogged();
     bool backtrackingLogged(); // solve the puzzle using backtracking if needed
-    
-    // helper function for further elmination of the possibilities  
+    SearchStatus search(const SearchLimits& limits = {}); // iterative backtracking, resumable
+    uint64_t nodeCount() const { return nodes; }
+    void setProfile(const PropagationProfile& p); // takes effect at the next propagation
+    const PropagationProfile& getProfile() const { return profile; }
+    void setRuleTiming(bool on) { timeRules = on; }
+    const RuleStats& ruleStats() const { return stats; }
+
+    // helper function for further elmination of the possibilities
     bool removeCol(int col, int num);
     bool removeRow(int row, int num);
     bool removeBox(int row, int col, int num);
@@ -46,8 +432,10 @@ public:
     bool advancedRemoveRow(int row, int col, int num);
     bool removeAll(int row, int col, int num);
     bool advancedRemoveAll(int row, int col, int num);
+    bool claimFromRow(int row, int num); // box-line reduction: num confined to one box of the row
+    bool claimFromCol(int col, int num);
 
-    // same helper functions for propagation but with logging 
+    // same helper functions for propagation but with logging
     bool removeColLogged(int col, int num);
     bool removeRowLogged(int row, int num);
     bool removeBoxLogged(int row, int col, int num);
@@ -57,9 +445,11 @@ public:
     bool advancedRemoveColLogged(int boxRow, int boxCol, int num);
     bool advancedRemoveRowLogged(int boxRow, int boxCol, int num);
     bool advancedRemoveAllLogged(int boxRow, int boxCol, int num);
-    
-    
-    void removePossibilitiesAfterInit(); // setup for the propagation 
+    bool claimFromRowLogged(int row, int num);
+    bool claimFromColLogged(int col, int num);
+
+
+    void removePossibilitiesAfterInit(); // setup for the propagation
 
     // more advanced elminators
     bool hiddenSingleRow(int row);
@@ -69,4 +459,62 @@ public:
     bool hasContradiction() const; // check if the board has a contradiction
     bool propagateAll(); // perform constraint propagation on the entire board
     bool solve(); // high-level solve function combining propagation and backtracking
+    SearchStatus solve(const SearchLimits& limits); // bounded solve; resumes an aborted search
+    uint64_t countSolutions(uint64_t limit); // stops at `limit`; the board is left on the last solution
+    SolutionCount countSolutions(uint64_t limit, const SearchLimits& limits); // limits cover the whole count
+};
+
+extern template class BasicSudokuBoard<3>;
+extern template class BasicSudokuBoard<4>;
+extern template class BasicSudokuBoard<5>;
+
+// Runtime front-end: selects BasicSudokuBoard<3|4|5> from the board size (9, 16 or 25)
+// and forwards the public solver API to it.
+class SudokuBoard
+{
+private:
+    std::variant<BasicSudokuBoard<3>, BasicSudokuBoard<4>, BasicSudokuBoard<5>> board;
+public:
+    explicit SudokuBoard(int boardSize);
+
+    static bool isSupportedSize(int boardSize) { return boardSize == 9 || boardSize == 16 || boardSize == 25; }
+    int size() const; // board size (9, 16 or 25)
+    int boxSize() const;
+
+    BoardError load(const std::string& puzzle);
+    bool loadFromString(const std::string& puzzle);
+    bool loadFromFile(const std::string& filename);
+    BoardError trySetValue(int row, int col, int num);
+    int getValueChecked(int row, int col) const;
+    void print() const;
+    void clear();
+    bool isSolved() const;
+    bool isConsistent() const;
+    bool hasContradiction() const;
+    int getValue(int row, int col) const; // value of a cell (0 = empty), unchecked
+
+    bool propagateAll();
+    bool propagateAllLogged();
+    bool backtracking();
+    bool backtrackingLogged();
+    bool solve();
+    SearchStatus solve(const SearchLimits& limits);
+    SearchStatus search(const SearchLimits& limits = {});
+    uint64_t countSolutions(uint64_t limit);
+    SolutionCount countSolutions(uint64_t limit, const SearchLimits& limits);
+    uint64_t nodeCount() const;
+    void setStateStrategy(StateStrategy s);
+    void setBackjumping(bool on);
+    void setValueOrder(ValueOrder order, uint64_t randomSeed = 1);
+    void setUnitBranching(bool on);
+    void setThreads(int count);
+    void setProfile(const PropagationProfile& p);
+    void setRuleTiming(bool on);
+    RuleStats ruleStats() const;
+
+    // direct access to the specialized board, e.g. std::visit-style generic code
+    template <typename F>
+    decltype(auto) visit(F&& f) { return std::visit(std::forward<F>(f), board); }
+    template <typename F>
+    decltype(auto) visit(F&& f) const { return std::visit(std::forward<F>(f), board); }
 };
@@ -0,0 +1,33 @@
+#pragma once
+// unitscan.h
+// Scans over one unit's position masks (State::unitPos[unit] in sudoku.h), for the hidden
+// singles and contradiction checks of both propagation variants. There is one mask per
+// number, bit p set while the unit's p-th cell can still take it. A scan answers, as masks of
+// numbers, which ones have exactly one place left in the unit (hidden singles) and which have
+// at least one; a number with none that is not placed in the unit yet is a contradiction.
+//
+// The masks of a unit are contiguous, so a whole 9- or 16-number unit is one or two vector
+// loads, a compare for "no bit" and "one bit" (m & (m - 1) == 0), and a movemask. Kernels:
+//   Portable - a plain loop
+//   Sse2     - 8 16-bit or 4 32-bit masks per instruction (x86-64 baseline)
+//   Avx2     - 16 or 8 per instruction, built with -mavx2 in unitscan_avx2.cpp
+// scanUnit uses the widest one the build has and the CPU runs, picked once.
+
+#include <cstdint>
+
+struct UnitScan
+{
+    uint32_t once = 0; // numbers with exactly one place left
+    uint32_t seen = 0; // numbers with at least one place left
+};
+
+enum class ScanIsa { Portable, Sse2, Avx2 };
+
+ScanIsa bestScanIsa();
+bool scanIsaSupported(ScanIsa isa);
+const char* scanIsaName(ScanIsa isa); // "portable", "sse2" or "avx2"
+
+UnitScan scanUnit(const uint16_t* masks, int n); // n <= 16
+UnitScan scanUnit(const uint32_t* masks, int n); // n <= 32
+UnitScan scanUnit(const uint16_t* masks, int n, ScanIsa isa); // a given kernel, for tests and benches
+UnitScan scanUnit(const uint32_t* masks, int n, ScanIsa isa);
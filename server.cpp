@@ -1,15 +1,30 @@
 #include "include/httplib.h"
-#include "include/sudoku.h"
+#include "include/batch.h"
+#include "include/solver.h"
 
+#include <algorithm>
 #include <iostream>
 #include <chrono>
+#include <cstdlib>
+#include <optional>
 #include <sstream>
+#include <thread>
+#include <vector>
 
 // ---------------- JSON helpers ----------------
 
+constexpr int maxCountLimit = 1000; // keeps a counting request on a near-empty board short
+
 struct Request {
     int size = 9;
     std::string board;
+    int timeLimitMs = 0; // 0 = no limit
+    std::string profile = "default"; // propagation profile, see PropagationProfile::named
+    std::string engine = "portfolio"; // see engineFromName
+    std::string valueOrder; // see valueOrderFromName; empty keeps the per-size default
+    int countLimit = 0; // > 0: also count solutions, up to this many
+    std::optional<int> threads; // capped at the hardware threads; empty keeps the engine's default
+    std::vector<std::string> boards; // POST /solve/batch
 };
 
 bool parseRequest(const std::string& json, Request& out) {
@@ -18,7 +33,11 @@ bool parseRequest(const std::string& json, Request& out) {
         if (pos == std::string::npos) return false;
         pos = json.find(":", pos);
         if (pos == std::string::npos) return false;
-        value = std::stoi(json.substr(pos + 1));
+        const char* begin = json.c_str() + pos + 1;
+        char* end = nullptr;
+        long parsed = std::strtol(begin, &end, 10); // no exceptions on malformed numbers
+        if (end == begin) return false;
+        value = static_cast<int>(parsed);
         return true;
     };
 
@@ -34,24 +53,68 @@ bool parseRequest(const std::string& json, Request& out) {
     };
 
     findInt("size", out.size);
+    findInt("time_limit_ms", out.timeLimitMs);
+    findString("profile", out.profile);
+    findString("engine", out.engine);
+    findString("value_order", out.valueOrder);
+    findInt("count_limit", out.countLimit);
+    int threads = 0;
+    if (findInt("threads", threads))
+        out.threads = threads;
     return findString("board", out.board);
 }
 
+// "boards": ["...", "..."], for POST /solve/batch
+bool parseBoards(const std::string& json, std::vector<std::string>& out) {
+    auto pos = json.find("\"boards\"");
+    if (pos == std::string::npos) return false;
+    pos = json.find("[", pos);
+    if (pos == std::string::npos) return false;
+    const auto close = json.find("]", pos);
+    if (close == std::string::npos) return false;
+    for (;;) {
+        auto begin = json.find("\"", pos + 1);
+        if (begin == std::string::npos || begin > close) return true;
+        auto end = json.find("\"", begin + 1);
+        if (end == std::string::npos || end > close) return false;
+        out.push_back(json.substr(begin + 1, end - begin - 1));
+        pos = end;
+    }
+}
+
 // ---------------- Helpers ----------------
 
-std::string boardToString(SudokuBoard& board, int size) {
-    std::string result;
-    result.reserve(size * size);
+void sendError(httplib::Response& res, int status, const std::string& message) {
+    res.status = status;
+    res.set_content(R"({"success":false,"error":")" + message + "\"}", "application/json");
+}
 
-    for (int i = 0; i < size; ++i) {
-        for (int j = 0; j < size; ++j) {
-            int val = board.getCell(i, j).getValue();
-            if (val == 0) result += '0';
-            else if (val <= 9) result += char('0' + val);
-            else result += char('A' + val - 10);
-        }
+// Checks the size and the named options shared by /solve and /solve/batch.
+// Returns the error message, or nullptr with the parsed options filled in.
+const char* parseOptions(const Request& parsed, BatchOptions& out) {
+    if (parsed.size != 9 && parsed.size != 16 && parsed.size != 25)
+        return "Invalid size";
+
+    if (!(out.profile = PropagationProfile::named(parsed.profile, parsed.size)))
+        return "Unknown profile";
+
+    std::optional<Engine> engine = engineFromName(parsed.engine);
+    if (!engine)
+        return "Unknown engine";
+    out.engine = *engine;
+
+    if (!parsed.valueOrder.empty() && !(out.valueOrder = valueOrderFromName(parsed.valueOrder)))
+        return "Unknown value order";
+
+    if (parsed.timeLimitMs > 0)
+        out.limits.maxTime = std::chrono::milliseconds(parsed.timeLimitMs);
+
+    // left at 0 when not given: solveBatch then uses every hardware thread
+    if (parsed.threads) {
+        const int hardwareThreads = std::max(1, (int)std::thread::hardware_concurrency());
+        out.threads = std::clamp(*parsed.threads, 1, hardwareThreads);
     }
-    return result;
+    return nullptr;
 }
 
 // ---------------- Main ----------------
@@ -69,6 +132,10 @@ int main() {
         res.status = 204;
     });
 
+    svr.Options("/solve/batch", [](auto&, auto& res) {
+        res.status = 204;
+    });
+
     svr.Get("/health", [](auto&, auto& res) {
         res.set_content("OK", "text/plain");
     });
@@ -78,55 +145,127 @@ int main() {
 
         Request parsed;
         if (!parseRequest(req.body, parsed)) {
-            res.status = 400;
-            res.set_content(R"({"success":false,"error":"Invalid JSON"})",
-                            "application/json");
+            sendError(res, 400, "Invalid JSON");
             return;
         }
 
-        if (parsed.size != 9 && parsed.size != 16 && parsed.size != 25) {
-            res.status = 400;
-            res.set_content(R"({"success":false,"error":"Invalid size"})",
-                            "application/json");
+        BatchOptions options;
+        if (const char* error = parseOptions(parsed, options)) {
+            sendError(res, 400, error);
             return;
         }
 
         if ((int)parsed.board.size() != parsed.size * parsed.size) {
-            res.status = 400;
-            res.set_content(R"({"success":false,"error":"Invalid board length"})",
-                            "application/json");
+            sendError(res, 400, "Invalid board length");
+            return;
+        }
+
+        std::unique_ptr<SudokuSolver> solver = makeSolver(options.engine, parsed.size);
+        SudokuSolver& board = *solver;
+        board.setProfile(*options.profile);
+        if (options.valueOrder) board.setValueOrder(*options.valueOrder);
+        if (parsed.threads) board.setThreads(options.threads); // else the race keeps its own racer count
+        BoardError error = board.load(parsed.board);
+        if (error != BoardError::None) {
+            sendError(res, 400, boardErrorMessage(error));
             return;
         }
 
-        SudokuBoard board(parsed.size);
-        if (!board.loadFromString(parsed.board)) {
-            res.status = 400;
-            res.set_content(R"({"success":false,"error":"Invalid board format"})",
-                            "application/json");
+        if (!board.isConsistent()) {
+            sendError(res, 400, "Board has duplicate values");
             return;
         }
 
-        bool solved = board.solve();
+        const SearchLimits& limits = options.limits;
+        SearchStatus status = board.solve(limits);
         auto end = std::chrono::high_resolution_clock::now();
         double time_ms =
             std::chrono::duration<double, std::milli>(end - start).count();
 
-        if (!solved) {
-            res.status = 200;
-            res.set_content(R"({"success":false,"error":"No solution"})",
-                            "application/json");
+        if (status == SearchStatus::Aborted) {
+            sendError(res, 200, "Time limit exceeded");
+            return;
+        }
+
+        if (status != SearchStatus::Solved) {
+            sendError(res, 200, "No solution");
             return;
         }
 
         std::ostringstream json;
         json << R"({"success":true,"board":")"
-             << boardToString(board, parsed.size)
-             << R"(","time_ms":)" << time_ms << "}";
+             << boardString(board)
+             << R"(","time_ms":)" << time_ms;
+
+        if (parsed.countLimit > 0) {
+            // counted on a fresh instance so the solution above stays intact
+            std::unique_ptr<SudokuSolver> counter = makeSolver(options.engine, parsed.size);
+            counter->setProfile(*options.profile);
+            counter->load(parsed.board);
+            const int countLimit = std::min(parsed.countLimit, maxCountLimit);
+
+            // the count shares the request's time limit with the solve
+            SearchLimits countLimits = limits;
+            SolutionCount counted{ 0, false };
+            if (limits.maxTime.count() > 0)
+                countLimits.maxTime -= std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                    std::chrono::high_resolution_clock::now() - start);
+            if (limits.maxTime.count() == 0 || countLimits.maxTime.count() > 0)
+                counted = counter->countSolutions(countLimit, countLimits);
+            json << R"(,"solutions":)" << counted.count
+                 << R"(,"count_complete":)" << (counted.complete ? "true" : "false");
+        }
+        json << "}";
 
         res.status = 200;
         res.set_content(json.str(), "application/json");
     });
 
+    // Many puzzles of one size in one request, solved on all hardware threads unless
+    // "threads" says fewer. Results come back in request order; a bad puzzle fails alone.
+    svr.Post("/solve/batch", [](const httplib::Request& req, httplib::Response& res) {
+        auto start = std::chrono::high_resolution_clock::now();
+
+        Request parsed;
+        parseRequest(req.body, parsed); // no single "board" here
+        if (!parseBoards(req.body, parsed.boards)) {
+            sendError(res, 400, "Invalid JSON");
+            return;
+        }
+
+        BatchOptions options;
+        if (const char* error = parseOptions(parsed, options)) {
+            sendError(res, 400, error);
+            return;
+        }
+
+        std::vector<BatchResult> results = solveBatch(parsed.boards, parsed.size, options);
+        auto end = std::chrono::high_resolution_clock::now();
+        double time_ms =
+            std::chrono::duration<double, std::milli>(end - start).count();
+
+        std::string json = R"({"success":true,"results":[)";
+        json.reserve(json.size() + results.size() * (parsed.size * parsed.size + 32));
+        for (size_t i = 0; i < results.size(); ++i) {
+            const BatchResult& result = results[i];
+            if (i > 0) json += ',';
+            if (result.error == BoardError::Conflict)
+                json += R"({"success":false,"error":"Board has duplicate values"})";
+            else if (result.error != BoardError::None)
+                json += std::string(R"({"success":false,"error":")") + boardErrorMessage(result.error) + "\"}";
+            else if (result.status == SearchStatus::Aborted)
+                json += R"({"success":false,"error":"Time limit exceeded"})";
+            else if (result.status != SearchStatus::Solved)
+                json += R"({"success":false,"error":"No solution"})";
+            else
+                json += R"({"success":true,"board":")" + result.solution + "\"}";
+        }
+        json += R"(],"time_ms":)" + std::to_string(time_ms) + "}";
+
+        res.status = 200;
+        res.set_content(json, "application/json");
+    });
+
     std::cout << "Sudoku Solver API running at http://localhost:8080/solve\n";
     std::cout << "Press Ctrl+C to stop.\n";
     svr.listen("0.0.0.0", 8080);
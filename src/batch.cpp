@@ -0,0 +1,130 @@
+#include "batch.h"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <thread>
+
+namespace
+{
+    // Puzzles a worker claims at once: enough to keep the shared counter cold on 9x9
+    // puzzles that solve in microseconds, few enough to balance slow 25x25 ones.
+    constexpr size_t chunkSize = 16;
+
+    std::unique_ptr<SudokuSolver> makeWorker(int boardSize, const BatchOptions& options)
+    {
+        std::unique_ptr<SudokuSolver> solver = makeSolver(options.engine, boardSize);
+        if (options.profile) solver->setProfile(*options.profile);
+        if (options.valueOrder) solver->setValueOrder(*options.valueOrder);
+        return solver;
+    }
+
+    // false, with the error filled in, for input that is never searched
+    bool loadOne(SudokuSolver& solver, const std::string& puzzle, BatchResult& result)
+    {
+        result.error = solver.load(puzzle);
+        if (result.error == BoardError::None && !solver.isConsistent())
+            result.error = BoardError::Conflict;
+        return result.error == BoardError::None;
+    }
+
+    void solveOne(SudokuSolver& solver, const std::string& puzzle, const SearchLimits& limits, BatchResult& result)
+    {
+        if (!loadOne(solver, puzzle, result))
+            return;
+
+        result.status = solver.solve(limits);
+        result.nodes = solver.nodeCount();
+        if (result.status == SearchStatus::Solved)
+            result.solution = boardString(solver);
+    }
+
+    // 9x9 puzzles the lanes take go through singles together; the others, and the lanes left
+    // stuck, go to the solver. `grids` is the worker's lane buffer, reused across chunks.
+    void solveLanes(SudokuSolver& solver, const std::string* puzzles, size_t count, BatchResult* results,
+                    const SearchLimits& limits, LaneIsa isa, std::string* grids)
+    {
+        size_t owner[maxLanes];
+        int lanes = 0;
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (laneReady(puzzles[i]))
+            {
+                grids[lanes] = puzzles[i];
+                owner[lanes++] = i;
+            }
+            else
+            {
+                solveOne(solver, puzzles[i], limits, results[i]);
+            }
+        }
+
+        const uint32_t dead = propagateLanes(grids, lanes, isa);
+        for (int l = 0; l < lanes; ++l)
+        {
+            BatchResult& result = results[owner[l]];
+            if (dead >> l & 1)
+                result.status = SearchStatus::Unsolvable;
+            else if (grids[l].find('0') != std::string::npos)
+                solveOne(solver, grids[l], limits, result);
+            else
+            {
+                result.status = SearchStatus::Solved;
+                result.solution = grids[l];
+            }
+        }
+    }
+}
+
+std::vector<BatchResult> solveBatch(const std::string* puzzles, size_t count, int boardSize, const BatchOptions& options)
+{
+    std::unique_ptr<SudokuSolver> own = makeWorker(boardSize, options); // throws on a bad size before any thread starts
+    std::vector<BatchResult> results(count);
+
+    const bool lockstep = options.lockstep && boardSize == 9;
+    LaneIsa isa = options.laneIsa.value_or(bestLaneIsa());
+    if (!laneIsaSupported(isa))
+        isa = bestLaneIsa();
+    const size_t claim = lockstep ? (size_t)laneCount(isa) : chunkSize;
+
+    int threads = options.threads > 0 ? options.threads : (int)std::thread::hardware_concurrency();
+    threads = (int)std::clamp<size_t>(threads, 1, std::max<size_t>((count + claim - 1) / claim, 1));
+
+    std::atomic<size_t> next{0};
+    auto work = [&](SudokuSolver& solver) {
+        std::string grids[maxLanes];
+        for (;;)
+        {
+            const size_t begin = next.fetch_add(claim, std::memory_order_relaxed);
+            if (begin >= count) return;
+            const size_t end = std::min(begin + claim, count);
+            if (options.limits.cancel && options.limits.cancel->load(std::memory_order_relaxed))
+            {
+                // a cancel stops the searches; bad input still reports what is wrong with it
+                for (size_t i = begin; i < end; ++i)
+                    if (loadOne(solver, puzzles[i], results[i]))
+                        results[i].status = SearchStatus::Aborted;
+                continue;
+            }
+
+            if (lockstep)
+            {
+                solveLanes(solver, puzzles + begin, end - begin, results.data() + begin, options.limits, isa, grids);
+                continue;
+            }
+            for (size_t i = begin; i < end; ++i)
+                solveOne(solver, puzzles[i], options.limits, results[i]);
+        }
+    };
+
+    std::vector<std::thread> pool;
+    pool.reserve(threads - 1);
+    for (int t = 1; t < threads; ++t)
+        pool.emplace_back([&] {
+            std::unique_ptr<SudokuSolver> solver = makeWorker(boardSize, options);
+            work(*solver);
+        });
+    work(*own);
+    for (std::thread& thread : pool)
+        thread.join();
+    return results;
+}
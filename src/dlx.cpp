@@ -0,0 +1,283 @@
+#include "dlx.h"
+#include <chrono>
+#include <stdexcept>
+
+DlxSolver::DlxSolver(int boardSize)
+    : n(boardSize)
+{
+    if (!SudokuBoard::isSupportedSize(boardSize))
+        throw std::invalid_argument("Board size must be 9, 16 or 25.");
+
+    box = n == 9 ? 3 : n == 16 ? 4 : 5;
+    columns = 4 * n * n;
+
+    const int total = 1 + columns + 4 * n * n * n; // root, headers, four nodes per candidate
+    left.resize(total);
+    right.resize(total);
+    up.resize(total);
+    down.resize(total);
+    column.resize(total);
+    candidate.resize(total);
+    columnSize.resize(columns + 1);
+
+    givens.assign(n * n, 0);
+    values.assign(n * n, 0);
+    levels.reserve(n * n); // one level per empty cell at most
+}
+
+BoardError DlxSolver::load(const std::string& puzzle)
+{
+    if ((int)puzzle.length() != n * n)
+        return BoardError::BadLength;
+
+    std::vector<uint8_t> cells(n * n, 0);
+    for (int i = 0; i < n * n; ++i)
+    {
+        int value = BasicSudokuBoard<3>::charToValue(puzzle[i]); // same for every order
+        if (value < 0) return BoardError::BadCharacter;
+        if (value > n) return BoardError::ValueOutOfRange;
+        cells[i] = uint8_t(value);
+    }
+
+    // duplicate givens load, like on SudokuBoard, but make the puzzle unsolvable
+    std::vector<uint32_t> rowSeen(n, 0), colSeen(n, 0), boxSeen(n, 0);
+    consistent = true;
+    for (int i = 0; i < n * n; ++i)
+    {
+        if (cells[i] == 0) continue;
+        const int r = i / n, c = i % n, b = (r / box) * box + c / box;
+        const uint32_t bit = 1u << (cells[i] - 1);
+        if ((rowSeen[r] | colSeen[c] | boxSeen[b]) & bit)
+            consistent = false;
+        rowSeen[r] |= bit;
+        colSeen[c] |= bit;
+        boxSeen[b] |= bit;
+    }
+
+    givens = cells;
+    values = cells;
+    levels.clear();
+    searching = false;
+    nodes = 0;
+    return BoardError::None;
+}
+
+void DlxSolver::reset()
+{
+    // headers: a circular list through the root, each column empty
+    for (int h = 0; h <= columns; ++h)
+    {
+        left[h] = h == 0 ? columns : h - 1;
+        right[h] = h == columns ? 0 : h + 1;
+        up[h] = down[h] = h;
+        column[h] = h;
+        columnSize[h] = 0;
+    }
+
+    const int nn = n * n;
+    int node = columns + 1;
+    for (int cell = 0; cell < nn; ++cell)
+    {
+        const int r = cell / n, c = cell % n, b = (r / box) * box + c / box;
+        for (int v = 0; v < n; ++v)
+        {
+            const int cols[4] = { 1 + cell, 1 + nn + r * n + v, 1 + 2 * nn + c * n + v, 1 + 3 * nn + b * n + v };
+            for (int k = 0; k < 4; ++k)
+            {
+                const int x = node + k;
+                left[x] = node + (k + 3) % 4;
+                right[x] = node + (k + 1) % 4;
+
+                const int col = cols[k];
+                up[x] = up[col];
+                down[x] = col;
+                down[up[col]] = x;
+                up[col] = x;
+                column[x] = col;
+                candidate[x] = cell * n + v;
+                ++columnSize[col];
+            }
+            node += 4;
+        }
+    }
+
+    // a given is a row chosen up front
+    for (int cell = 0; cell < nn; ++cell)
+    {
+        if (givens[cell] == 0) continue;
+        const int row = columns + 1 + 4 * (cell * n + givens[cell] - 1);
+        cover(column[row]);
+        select(row);
+    }
+}
+
+void DlxSolver::cover(int col)
+{
+    right[left[col]] = right[col];
+    left[right[col]] = left[col];
+
+    for (int i = down[col]; i != col; i = down[i])
+        for (int j = right[i]; j != i; j = right[j])
+        {
+            up[down[j]] = up[j];
+            down[up[j]] = down[j];
+            --columnSize[column[j]];
+        }
+}
+
+void DlxSolver::uncover(int col)
+{
+    for (int i = up[col]; i != col; i = up[i])
+        for (int j = left[i]; j != i; j = left[j])
+        {
+            ++columnSize[column[j]];
+            up[down[j]] = j;
+            down[up[j]] = j;
+        }
+
+    right[left[col]] = col;
+    left[right[col]] = col;
+}
+
+void DlxSolver::select(int row)
+{
+    for (int j = right[row]; j != row; j = right[j])
+        cover(column[j]);
+}
+
+void DlxSolver::unselect(int row)
+{
+    for (int j = left[row]; j != row; j = left[j])
+        uncover(column[j]);
+}
+
+int DlxSolver::chooseColumn() const
+{
+    int best = right[0];
+    for (int col = right[0]; col != 0; col = right[col])
+    {
+        if (columnSize[col] < columnSize[best])
+            best = col;
+        if (columnSize[best] <= 1)
+            break; // forced or dead: nothing smaller exists
+    }
+    return best;
+}
+
+void DlxSolver::recordSolution()
+{
+    values = givens;
+    for (const Level& level : levels)
+    {
+        const int c = candidate[level.row];
+        values[c / n] = uint8_t(c % n + 1);
+    }
+}
+
+SearchStatus DlxSolver::run(const SearchLimits& limits)
+{
+    const auto start = std::chrono::steady_clock::now();
+    const uint64_t startNodes = nodes;
+
+    while (true)
+    {
+        if (descend)
+        {
+            descend = false;
+            if (right[0] == 0)
+            {
+                recordSolution(); // every constraint covered
+                return SearchStatus::Solved;
+            }
+
+            const int col = chooseColumn();
+            if (columnSize[col] > 0)
+            {
+                cover(col);
+                levels.push_back({ col, col });
+            }
+            continue; // an empty column fails the node: the top level moves on
+        }
+
+        if (levels.empty())
+            return SearchStatus::Unsolvable;
+
+        // budgets are checked between rows, where the search can be resumed as is
+        if (limits.cancel && limits.cancel->load(std::memory_order_relaxed))
+            return SearchStatus::Aborted;
+        if (limits.maxNodes && nodes - startNodes >= limits.maxNodes)
+            return SearchStatus::Aborted;
+        if (limits.maxTime.count() > 0 && (nodes & 63) == 0 &&
+            std::chrono::steady_clock::now() - start >= limits.maxTime)
+            return SearchStatus::Aborted;
+
+        Level& top = levels.back();
+        if (top.row != top.col)
+            unselect(top.row);
+
+        top.row = down[top.row];
+        if (top.row == top.col)
+        {
+            uncover(top.col); // every row of the column failed: backtrack
+            levels.pop_back();
+            continue;
+        }
+
+        select(top.row);
+        ++nodes;
+        descend = true;
+    }
+}
+
+SearchStatus DlxSolver::solve(const SearchLimits& limits)
+{
+    if (!searching)
+    {
+        if (!consistent)
+            return SearchStatus::Unsolvable;
+        reset();
+        levels.clear();
+        nodes = 0;
+        descend = true;
+        searching = true;
+    }
+
+    SearchStatus status = run(limits);
+    if (status != SearchStatus::Aborted)
+        searching = false;
+    return status;
+}
+
+SolutionCount DlxSolver::countSolutions(uint64_t limit, const SearchLimits& limits)
+{
+    SolutionCount result;
+    if (!consistent)
+        return result;
+
+    reset();
+    levels.clear();
+    nodes = 0;
+    descend = true;
+
+    // after a solution the search simply moves on to the next row
+    const auto start = std::chrono::steady_clock::now();
+    SearchLimits rest;
+    while (result.count < limit)
+    {
+        if (!remainingLimits(limits, start, nodes, rest))
+        {
+            result.complete = false;
+            break;
+        }
+        const SearchStatus status = run(rest);
+        if (status != SearchStatus::Solved)
+        {
+            result.complete = status != SearchStatus::Aborted;
+            break;
+        }
+        ++result.count;
+    }
+
+    searching = false;
+    return result;
+}
@@ -0,0 +1,121 @@
+#include "lockstep.h"
+
+#define LOCKSTEP_LANES 8
+#define LOCKSTEP_NAMESPACE lockstepGeneric
+#include "lockstep_kernel.h"
+
+// kernels built with wider target flags, in their own translation units
+#ifdef SUDOKU_LOCKSTEP_AVX2
+namespace lockstepAvx2 { uint32_t propagate(uint16_t* masks); }
+#endif
+#ifdef SUDOKU_LOCKSTEP_AVX512
+namespace lockstepAvx512 { uint32_t propagate(uint16_t* masks); }
+#endif
+
+bool laneIsaSupported(LaneIsa isa)
+{
+    switch (isa)
+    {
+        case LaneIsa::Generic: return true;
+#ifdef SUDOKU_LOCKSTEP_AVX2
+        case LaneIsa::Avx2:    return __builtin_cpu_supports("avx2");
+#endif
+#ifdef SUDOKU_LOCKSTEP_AVX512
+        case LaneIsa::Avx512:  return __builtin_cpu_supports("avx512bw");
+#endif
+        default:               return false;
+    }
+}
+
+LaneIsa bestLaneIsa()
+{
+    static const LaneIsa best = laneIsaSupported(LaneIsa::Avx512) ? LaneIsa::Avx512
+                              : laneIsaSupported(LaneIsa::Avx2)   ? LaneIsa::Avx2
+                                                                  : LaneIsa::Generic;
+    return best;
+}
+
+int laneCount(LaneIsa isa)
+{
+    return isa == LaneIsa::Avx512 ? 32 : isa == LaneIsa::Avx2 ? 16 : 8;
+}
+
+const char* laneIsaName(LaneIsa isa)
+{
+    switch (isa)
+    {
+        case LaneIsa::Generic: return "generic";
+        case LaneIsa::Avx2:    return "avx2";
+        case LaneIsa::Avx512:  return "avx512";
+    }
+    return "unknown";
+}
+
+std::optional<LaneIsa> laneIsaFromName(const std::string& name)
+{
+    if (name == "generic") return LaneIsa::Generic;
+    if (name == "avx2") return LaneIsa::Avx2;
+    if (name == "avx512") return LaneIsa::Avx512;
+    return std::nullopt;
+}
+
+bool laneReady(const std::string& puzzle)
+{
+    if (puzzle.size() != 81)
+        return false;
+
+    uint16_t rows[9] = {}, cols[9] = {}, boxes[9] = {};
+    for (int id = 0; id < 81; ++id)
+    {
+        const char ch = puzzle[id];
+        if (ch == '0' || ch == '.')
+            continue;
+        if (ch < '1' || ch > '9')
+            return false;
+
+        const uint16_t bit = uint16_t(1u << (ch - '1'));
+        const int r = id / 9, c = id % 9, b = r / 3 * 3 + c / 3;
+        if ((rows[r] | cols[c] | boxes[b]) & bit)
+            return false;
+        rows[r] |= bit;
+        cols[c] |= bit;
+        boxes[b] |= bit;
+    }
+    return true;
+}
+
+uint32_t propagateLanes(std::string* puzzles, int count, LaneIsa isa)
+{
+    if (!laneIsaSupported(isa))
+        isa = bestLaneIsa();
+    const int lanes = laneCount(isa);
+
+    // unused lanes stay all-zero: a contradiction from the first unit on, which nobody reads
+    alignas(64) uint16_t masks[81 * maxLanes] = {};
+    for (int l = 0; l < count; ++l)
+        for (int id = 0; id < 81; ++id)
+        {
+            const char ch = puzzles[l][id];
+            masks[id * lanes + l] = ch >= '1' && ch <= '9' ? uint16_t(1u << (ch - '1')) : uint16_t(0x1FF);
+        }
+
+    uint32_t dead;
+    switch (isa)
+    {
+#ifdef SUDOKU_LOCKSTEP_AVX2
+        case LaneIsa::Avx2:   dead = lockstepAvx2::propagate(masks); break;
+#endif
+#ifdef SUDOKU_LOCKSTEP_AVX512
+        case LaneIsa::Avx512: dead = lockstepAvx512::propagate(masks); break;
+#endif
+        default:              dead = lockstepGeneric::propagate(masks); break;
+    }
+
+    for (int l = 0; l < count; ++l)
+        for (int id = 0; id < 81; ++id)
+        {
+            const uint16_t m = masks[id * lanes + l];
+            puzzles[l][id] = m != 0 && (m & (m - 1)) == 0 ? char('1' + __builtin_ctz(m)) : '0';
+        }
+    return dead & (count == 32 ? ~0u : (1u << count) - 1);
+}
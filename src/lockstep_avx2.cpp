@@ -0,0 +1,5 @@
+// lockstep_avx2.cpp
+// The lane kernel built with -mavx2 (see CMakeLists.txt); only called on CPUs that have it.
+#define LOCKSTEP_LANES 16
+#define LOCKSTEP_NAMESPACE lockstepAvx2
+#include "lockstep_kernel.h"
@@ -0,0 +1,5 @@
+// lockstep_avx512.cpp
+// The lane kernel built with -mavx512bw (see CMakeLists.txt); only called on CPUs that have it.
+#define LOCKSTEP_LANES 32
+#define LOCKSTEP_NAMESPACE lockstepAvx512
+#include "lockstep_kernel.h"
@@ -0,0 +1,100 @@
+#pragma once
+// lockstep_kernel.h
+// The lane kernel behind propagateLanes (lockstep.h), compiled once per instruction set. The
+// including file defines LOCKSTEP_LANES and LOCKSTEP_NAMESPACE and is built with the target's
+// flags; everything here lives in that namespace, so no code built for a wider instruction set
+// can stand in for a shared inline function elsewhere in the program.
+//
+// Lane l of every vector belongs to puzzle l. A cell is a vector of candidate masks (bit d-1 for
+// digit d), so one bitwise operation updates that cell in every puzzle at once. Lanes never
+// branch: a lane with nothing left to do just stops changing.
+
+#include <cstdint>
+
+namespace LOCKSTEP_NAMESPACE
+{
+    constexpr int lanes = LOCKSTEP_LANES;
+    typedef uint16_t Vec __attribute__((vector_size(2 * LOCKSTEP_LANES)));
+
+    struct Units
+    {
+        uint8_t cells[27][9]; // rows, columns, boxes
+    };
+
+    constexpr Units makeUnits()
+    {
+        Units u{};
+        for (int i = 0; i < 9; ++i)
+            for (int k = 0; k < 9; ++k)
+            {
+                u.cells[i][k] = uint8_t(i * 9 + k);
+                u.cells[9 + i][k] = uint8_t(k * 9 + i);
+                u.cells[18 + i][k] = uint8_t((i / 3 * 3 + k / 3) * 9 + i % 3 * 3 + k % 3);
+            }
+        return u;
+    }
+
+    constexpr Units units = makeUnits();
+
+    inline bool any(const Vec& v)
+    {
+        uint64_t words[sizeof(Vec) / 8];
+        __builtin_memcpy(words, &v, sizeof v);
+        uint64_t bits = 0;
+        for (uint64_t w : words)
+            bits |= w;
+        return bits != 0;
+    }
+
+    // masks: 81 cells of `lanes` candidate masks each, cell-major. Runs naked and hidden singles
+    // on every lane until none changes, and returns the lanes that hit a contradiction (bit l).
+    uint32_t propagate(uint16_t* masks)
+    {
+        Vec cells[81];
+        __builtin_memcpy(cells, masks, sizeof cells);
+
+        const Vec allDigits = Vec{} + 0x1FF;
+        Vec dead{};
+        for (;;)
+        {
+            Vec changed{};
+            for (const auto& unit : units.cells)
+            {
+                // digits seen in at least one cell, in two or more, and already placed
+                Vec once{}, twice{}, placed{}, clash{};
+                for (int id : unit)
+                {
+                    const Vec m = cells[id];
+                    twice |= once & m;
+                    once |= m;
+                    const Vec single = m & (Vec)((m & (m - 1)) == 0);
+                    clash |= placed & single;
+                    placed |= single;
+                }
+                dead |= (Vec)(clash != 0) | (Vec)(once != allDigits);
+
+                const Vec hidden = once & ~twice & ~placed; // one place left, not yet placed
+                for (int id : unit)
+                {
+                    const Vec m = cells[id];
+                    const Vec open = (Vec)((m & (m - 1)) != 0);
+                    Vec next = m & ~(placed & open); // naked singles: drop the placed digits
+                    const Vec h = next & hidden;
+                    const Vec forced = (Vec)(h != 0);
+                    next = (next & ~forced) | (h & forced); // hidden singles
+                    dead |= (Vec)((h & (h - 1)) != 0) | (Vec)(next == 0);
+                    changed |= next ^ m;
+                    cells[id] = next;
+                }
+            }
+            if (!any(changed & ~dead))
+                break;
+        }
+
+        __builtin_memcpy(masks, cells, sizeof cells);
+        uint32_t deadLanes = 0;
+        for (int l = 0; l < lanes; ++l)
+            if (dead[l]) deadLanes |= 1u << l;
+        return deadLanes;
+    }
+}
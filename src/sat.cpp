@@ -0,0 +1,612 @@
+#include "sat.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace
+{
+    constexpr double varDecay = 0.95;
+    constexpr uint64_t restartBase = 100; // conflicts per Luby unit
+
+    // Luby sequence 1 1 2 1 1 2 4 1 1 2 ..., scaled by powers of y
+    double luby(double y, int x)
+    {
+        int size = 1, seq = 0;
+        while (size < x + 1)
+        {
+            ++seq;
+            size = 2 * size + 1;
+        }
+        while (size - 1 != x)
+        {
+            size = (size - 1) >> 1;
+            --seq;
+            x = x % size;
+        }
+        return std::pow(y, seq);
+    }
+}
+
+int CdclSolver::newVar()
+{
+    const int var = varCount();
+    assigns.push_back(-1);
+    level.push_back(0);
+    reason.push_back(noReason);
+    activity.push_back(0.0);
+    heapPos.push_back(-1);
+    phase.push_back(false); // a cell-digit pair is false far more often than true
+    model.push_back(false);
+    seen.push_back(0);
+    levelStamp.push_back(0);
+    watches.emplace_back();
+    watches.emplace_back();
+    heapInsert(var);
+    return var;
+}
+
+bool CdclSolver::addClause(std::vector<int> lits)
+{
+    if (unsat) return false;
+    cancelUntil(0);
+
+    // drop literals false at the root and repeats; satisfied clauses and tautologies are dropped whole
+    std::sort(lits.begin(), lits.end());
+    size_t j = 0;
+    int prev = -2;
+    for (int lit : lits)
+    {
+        if (value(lit) == 1 || lit == (prev ^ 1)) return true;
+        if (value(lit) == 0 || lit == prev) continue;
+        lits[j++] = prev = lit;
+    }
+    lits.resize(j);
+
+    if (lits.empty())
+    {
+        unsat = true;
+        return false;
+    }
+    if (lits.size() == 1)
+    {
+        enqueue(lits[0], noReason);
+        if (propagate() != noReason) unsat = true;
+        return !unsat;
+    }
+    attach(allocClause(lits, false, 0));
+    return true;
+}
+
+uint32_t CdclSolver::allocClause(const std::vector<int>& lits, bool isLearntClause, uint32_t clauseLbd)
+{
+    const uint32_t cref = (uint32_t)arena.size();
+    arena.push_back((uint32_t)lits.size());
+    arena.push_back((isLearntClause ? 1u : 0u) | (clauseLbd << 2));
+    for (int lit : lits)
+        arena.push_back((uint32_t)lit);
+    return cref;
+}
+
+void CdclSolver::attach(uint32_t cref)
+{
+    const uint32_t* c = clauseLits(cref);
+    const uint32_t tag = clauseSize(cref) == 2 ? binaryFlag : 0;
+    watches[c[0]].push_back({ cref | tag, (int)c[1] });
+    watches[c[1]].push_back({ cref | tag, (int)c[0] });
+}
+
+void CdclSolver::enqueue(int lit, uint32_t from)
+{
+    const int var = lit >> 1;
+    assigns[var] = (lit & 1) ? 0 : 1;
+    level[var] = decisionLevel();
+    reason[var] = from;
+    trail.push_back(lit);
+}
+
+uint32_t CdclSolver::propagate()
+{
+    uint32_t confl = noReason;
+    while (qhead < trail.size() && confl == noReason)
+    {
+        const int falseLit = trail[qhead++] ^ 1;
+        std::vector<Watch>& ws = watches[falseLit];
+        size_t i = 0, j = 0;
+        while (i < ws.size())
+        {
+            const Watch w = ws[i++];
+            const int blockerValue = value(w.blocker);
+            if (blockerValue == 1)
+            {
+                ws[j++] = w;
+                continue;
+            }
+
+            if (w.cref & binaryFlag)
+            {
+                // the other literal is the whole rest of the clause
+                ws[j++] = w;
+                if (blockerValue == 0)
+                {
+                    confl = w.cref & ~binaryFlag;
+                    break;
+                }
+                enqueue(w.blocker, w.cref & ~binaryFlag);
+                continue;
+            }
+
+            // keep the false literal in slot 1, so slot 0 is the one implied
+            const uint32_t cref = w.cref;
+            uint32_t* c = clauseLits(cref);
+            if ((int)c[0] == falseLit) std::swap(c[0], c[1]);
+            const int first = (int)c[0];
+            if (first != w.blocker && value(first) == 1)
+            {
+                ws[j++] = { cref, first };
+                continue;
+            }
+
+            bool moved = false;
+            const uint32_t size = clauseSize(cref);
+            for (uint32_t k = 2; k < size; ++k)
+            {
+                if (value((int)c[k]) != 0)
+                {
+                    std::swap(c[1], c[k]);
+                    watches[c[1]].push_back({ cref, first });
+                    moved = true;
+                    break;
+                }
+            }
+            if (moved) continue;
+
+            ws[j++] = { cref, first };
+            if (value(first) == 0)
+            {
+                confl = cref;
+                break;
+            }
+            enqueue(first, cref);
+        }
+        while (i < ws.size())
+            ws[j++] = ws[i++];
+        ws.resize(j);
+    }
+    return confl;
+}
+
+void CdclSolver::analyze(uint32_t confl, int& backLevel, uint32_t& clauseLbd)
+{
+    // walk the trail back from the conflict until one literal of the current level is left
+    learnt.clear();
+    learnt.push_back(0); // the asserting literal, known at the end
+    int pathCount = 0;
+    int p = -1;
+    int index = (int)trail.size() - 1;
+    do
+    {
+        const uint32_t size = clauseSize(confl);
+        const uint32_t* c = clauseLits(confl);
+        for (uint32_t k = 0; k < size; ++k)
+        {
+            const int q = (int)c[k];
+            const int var = q >> 1;
+            if ((p >= 0 && var == (p >> 1)) || seen[var] || level[var] == 0) continue;
+            seen[var] = 1;
+            bumpVar(var);
+            if (level[var] >= decisionLevel()) ++pathCount;
+            else learnt.push_back(q);
+        }
+        while (!seen[trail[index] >> 1]) --index;
+        p = trail[index--];
+        confl = reason[p >> 1];
+        seen[p >> 1] = 0;
+        --pathCount;
+    } while (pathCount > 0);
+    learnt[0] = p ^ 1;
+
+    // drop literals implied by the others through their own reason
+    toClear.assign(learnt.begin(), learnt.end());
+    size_t j = 1;
+    for (size_t i = 1; i < learnt.size(); ++i)
+        if (reason[learnt[i] >> 1] == noReason || !redundant(learnt[i]))
+            learnt[j++] = learnt[i];
+    learnt.resize(j);
+    for (int lit : toClear) seen[lit >> 1] = 0;
+
+    backLevel = 0;
+    if (learnt.size() > 1)
+    {
+        size_t best = 1;
+        for (size_t i = 2; i < learnt.size(); ++i)
+            if (level[learnt[i] >> 1] > level[learnt[best] >> 1]) best = i;
+        std::swap(learnt[1], learnt[best]);
+        backLevel = level[learnt[1] >> 1];
+    }
+
+    ++stamp;
+    clauseLbd = 0;
+    for (int lit : learnt)
+    {
+        const int lvl = level[lit >> 1];
+        if (levelStamp[lvl] != stamp)
+        {
+            levelStamp[lvl] = stamp;
+            ++clauseLbd;
+        }
+    }
+}
+
+bool CdclSolver::redundant(int lit)
+{
+    const int var = lit >> 1;
+    const uint32_t cref = reason[var];
+    const uint32_t size = clauseSize(cref);
+    const uint32_t* c = clauseLits(cref);
+    for (uint32_t k = 0; k < size; ++k)
+    {
+        const int other = (int)c[k] >> 1;
+        if (other != var && !seen[other] && level[other] > 0) return false;
+    }
+    return true;
+}
+
+void CdclSolver::cancelUntil(int lvl)
+{
+    if (decisionLevel() <= lvl) return;
+    for (int i = (int)trail.size() - 1; i >= trailLim[lvl]; --i)
+    {
+        const int var = trail[i] >> 1;
+        phase[var] = assigns[var] == 1;
+        assigns[var] = -1;
+        reason[var] = noReason;
+        if (heapPos[var] < 0) heapInsert(var);
+    }
+    trail.resize(trailLim[lvl]);
+    trailLim.resize(lvl);
+    qhead = trail.size();
+}
+
+void CdclSolver::reduceLearnts()
+{
+    // worst (highest LBD) first; binaries, glue clauses and reasons stay
+    std::sort(learnts.begin(), learnts.end(), [&](uint32_t a, uint32_t b) { return lbd(a) > lbd(b); });
+    const size_t half = learnts.size() / 2;
+    for (size_t i = 0; i < half; ++i)
+    {
+        const uint32_t cref = learnts[i];
+        const int first = (int)clauseLits(cref)[0];
+        const bool locked = value(first) == 1 && reason[first >> 1] == cref;
+        if (clauseSize(cref) > 2 && lbd(cref) > 2 && !locked)
+            arena[cref + 1] |= 2;
+    }
+
+    // compact the arena and rewrite every reference to it
+    std::vector<uint32_t> compacted;
+    compacted.reserve(arena.size());
+    std::vector<uint32_t> forward(arena.size(), noReason);
+    for (uint32_t pos = 0; pos < arena.size(); pos += 2 + arena[pos])
+    {
+        if (isDeleted(pos)) continue;
+        forward[pos] = (uint32_t)compacted.size();
+        compacted.insert(compacted.end(), arena.begin() + pos, arena.begin() + pos + 2 + arena[pos]);
+    }
+
+    for (std::vector<Watch>& ws : watches)
+    {
+        size_t j = 0;
+        for (const Watch& w : ws)
+        {
+            const uint32_t to = forward[w.cref & ~binaryFlag];
+            if (to != noReason) ws[j++] = { to | (w.cref & binaryFlag), w.blocker };
+        }
+        ws.resize(j);
+    }
+    for (int lit : trail)
+        if (reason[lit >> 1] != noReason)
+            reason[lit >> 1] = forward[reason[lit >> 1]];
+
+    size_t j = 0;
+    for (uint32_t cref : learnts)
+        if (forward[cref] != noReason) learnts[j++] = forward[cref];
+    learnts.resize(j);
+    arena.swap(compacted);
+}
+
+void CdclSolver::bumpVar(int var)
+{
+    activity[var] += varInc;
+    if (activity[var] > 1e100)
+    {
+        for (double& a : activity) a *= 1e-100;
+        varInc *= 1e-100;
+    }
+    if (heapPos[var] >= 0) heapUp(heapPos[var]);
+}
+
+void CdclSolver::heapUp(int pos)
+{
+    const int var = heap[pos];
+    while (pos > 0)
+    {
+        const int parent = (pos - 1) / 2;
+        if (activity[heap[parent]] >= activity[var]) break;
+        heap[pos] = heap[parent];
+        heapPos[heap[pos]] = pos;
+        pos = parent;
+    }
+    heap[pos] = var;
+    heapPos[var] = pos;
+}
+
+void CdclSolver::heapDown(int pos)
+{
+    const int var = heap[pos];
+    const int size = (int)heap.size();
+    while (true)
+    {
+        int child = 2 * pos + 1;
+        if (child >= size) break;
+        if (child + 1 < size && activity[heap[child + 1]] > activity[heap[child]]) ++child;
+        if (activity[heap[child]] <= activity[var]) break;
+        heap[pos] = heap[child];
+        heapPos[heap[pos]] = pos;
+        pos = child;
+    }
+    heap[pos] = var;
+    heapPos[var] = pos;
+}
+
+void CdclSolver::heapInsert(int var)
+{
+    heap.push_back(var);
+    heapPos[var] = (int)heap.size() - 1;
+    heapUp(heapPos[var]);
+}
+
+int CdclSolver::heapPop()
+{
+    const int top = heap[0];
+    heapPos[top] = -1;
+    const int last = heap.back();
+    heap.pop_back();
+    if (!heap.empty())
+    {
+        heap[0] = last;
+        heapPos[last] = 0;
+        heapDown(0);
+    }
+    return top;
+}
+
+int CdclSolver::pickBranchVar()
+{
+    while (!heap.empty())
+    {
+        const int var = heapPop();
+        if (assigns[var] < 0) return var;
+    }
+    return -1;
+}
+
+SearchStatus CdclSolver::solve(const SearchLimits& limits)
+{
+    if (unsat) return SearchStatus::Unsolvable;
+    if (restartLimit == 0) restartLimit = restartBase;
+
+    const auto start = std::chrono::steady_clock::now();
+    const uint64_t startDecisions = decisions;
+
+    while (true)
+    {
+        const uint32_t confl = propagate();
+        if (confl != noReason)
+        {
+            ++conflicts;
+            ++restartConflicts;
+            if (decisionLevel() == 0)
+            {
+                unsat = true;
+                return SearchStatus::Unsolvable;
+            }
+
+            int backLevel;
+            uint32_t clauseLbd;
+            analyze(confl, backLevel, clauseLbd);
+            cancelUntil(backLevel);
+            if (learnt.size() == 1)
+            {
+                enqueue(learnt[0], noReason);
+            }
+            else
+            {
+                const uint32_t cref = allocClause(learnt, true, clauseLbd);
+                attach(cref);
+                learnts.push_back(cref);
+                enqueue(learnt[0], cref);
+            }
+            varInc /= varDecay;
+            continue;
+        }
+
+        if (restartConflicts >= restartLimit)
+        {
+            cancelUntil(0);
+            restartConflicts = 0;
+            restartLimit = uint64_t(restartBase * luby(2, ++restarts));
+        }
+        if (conflicts >= nextReduce)
+        {
+            reduceLearnts();
+            nextReduce = conflicts + 2000 + 300 * uint64_t(++reductions);
+        }
+
+        // budgets are checked at decisions, where the search can be resumed as is
+        if (limits.cancel && limits.cancel->load(std::memory_order_relaxed))
+            return SearchStatus::Aborted;
+        if (limits.maxNodes && decisions - startDecisions >= limits.maxNodes)
+            return SearchStatus::Aborted;
+        if (limits.maxTime.count() > 0 && (decisions & 63) == 0 &&
+            std::chrono::steady_clock::now() - start >= limits.maxTime)
+            return SearchStatus::Aborted;
+
+        const int var = pickBranchVar();
+        if (var < 0)
+        {
+            for (int v = 0; v < varCount(); ++v)
+                model[v] = assigns[v] == 1;
+            return SearchStatus::Solved;
+        }
+
+        ++decisions;
+        trailLim.push_back((int)trail.size());
+        enqueue(literal(var, !phase[var]), noReason);
+    }
+}
+
+SatSudokuSolver::SatSudokuSolver(int boardSize)
+    : n(boardSize), board(boardSize), values(boardSize * boardSize, 0)
+{
+}
+
+BoardError SatSudokuSolver::load(const std::string& puzzle)
+{
+    BoardError error = board.load(puzzle);
+    if (error != BoardError::None) return error;
+
+    for (int id = 0; id < n * n; ++id)
+        values[id] = uint8_t(board.getValue(id / n, id % n));
+    sat.reset();
+    searching = false;
+    return BoardError::None;
+}
+
+bool SatSudokuSolver::encode()
+{
+    if (!board.isConsistent() || !board.propagateAll())
+        return false;
+
+    // one variable per candidate left after propagation
+    sat = std::make_unique<CdclSolver>();
+    varCell.clear();
+    varValue.clear();
+    std::vector<int> varOf(n * n * n, -1);
+    board.visit([&](const auto& b)
+    {
+        for (int id = 0; id < n * n; ++id)
+        {
+            const auto& cl = b.getCell(id / n, id % n);
+            values[id] = uint8_t(cl.getValue());
+            if (cl.getValue() != 0) continue;
+            for (int v = 1; v <= n; ++v)
+            {
+                if (!((cl.getPossibilities() >> (v - 1)) & 1)) continue;
+                varOf[id * n + v - 1] = sat->newVar();
+                varCell.push_back(id);
+                varValue.push_back(v);
+            }
+        }
+    });
+
+    std::vector<int> vars;
+    auto exactlyOne = [&]()
+    {
+        std::vector<int> clause;
+        for (int var : vars) clause.push_back(CdclSolver::literal(var, false));
+        bool ok = sat->addClause(clause);
+        for (size_t i = 0; i < vars.size() && ok; ++i)
+            for (size_t j = i + 1; j < vars.size() && ok; ++j)
+                ok = sat->addClause({ CdclSolver::literal(vars[i], true), CdclSolver::literal(vars[j], true) });
+        return ok;
+    };
+
+    for (int id = 0; id < n * n; ++id)
+    {
+        if (values[id] != 0) continue;
+        vars.clear();
+        for (int v = 0; v < n; ++v)
+            if (varOf[id * n + v] >= 0) vars.push_back(varOf[id * n + v]);
+        if (!exactlyOne()) return false;
+    }
+
+    // units: rows, then columns, then boxes, as in BoardGeometry
+    const int box = board.boxSize();
+    std::vector<int> cells(n);
+    for (int unit = 0; unit < 3 * n; ++unit)
+    {
+        const int u = unit % n;
+        for (int j = 0; j < n; ++j)
+        {
+            if (unit < n) cells[j] = u * n + j;
+            else if (unit < 2 * n) cells[j] = j * n + u;
+            else cells[j] = ((u / box) * box + j / box) * n + (u % box) * box + j % box;
+        }
+
+        for (int v = 1; v <= n; ++v)
+        {
+            bool placed = false;
+            vars.clear();
+            for (int id : cells)
+            {
+                placed = placed || values[id] == v;
+                if (varOf[id * n + v - 1] >= 0) vars.push_back(varOf[id * n + v - 1]);
+            }
+            if (!placed && !exactlyOne()) return false;
+        }
+    }
+    return true;
+}
+
+void SatSudokuSolver::readModel()
+{
+    for (int var = 0; var < sat->varCount(); ++var)
+        if (sat->modelValue(var))
+            values[varCell[var]] = uint8_t(varValue[var]);
+}
+
+SearchStatus SatSudokuSolver::solve(const SearchLimits& limits)
+{
+    if (!searching)
+    {
+        if (!encode()) return SearchStatus::Unsolvable;
+        searching = true;
+    }
+
+    SearchStatus status = sat->solve(limits);
+    if (status == SearchStatus::Solved) readModel();
+    if (status != SearchStatus::Aborted) searching = false;
+    return status;
+}
+
+SolutionCount SatSudokuSolver::countSolutions(uint64_t limit, const SearchLimits& limits)
+{
+    searching = false;
+    SolutionCount result;
+    if (!encode()) return result;
+
+    const auto start = std::chrono::steady_clock::now();
+    SearchLimits rest;
+    while (result.count < limit)
+    {
+        if (!remainingLimits(limits, start, nodeCount(), rest))
+        {
+            result.complete = false;
+            break;
+        }
+        const SearchStatus status = sat->solve(rest);
+        if (status != SearchStatus::Solved)
+        {
+            result.complete = status != SearchStatus::Aborted;
+            break;
+        }
+        readModel();
+        ++result.count;
+
+        // block this solution: some cell has to take another digit
+        std::vector<int> block;
+        for (int var = 0; var < sat->varCount(); ++var)
+            if (sat->modelValue(var)) block.push_back(CdclSolver::literal(var, true));
+        if (!sat->addClause(block)) break;
+    }
+    return result;
+}
@@ -0,0 +1,333 @@
+#include "solver.h"
+#include "dlx.h"
+#include "sat.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    // SudokuBoard behind the common interface
+    class PropagationSolver : public SudokuSolver
+    {
+    public:
+        explicit PropagationSolver(int boardSize) : board(boardSize) {}
+
+        int size() const override { return board.size(); }
+        BoardError load(const std::string& puzzle) override { return board.load(puzzle); }
+        bool isConsistent() const override { return board.isConsistent(); }
+        SearchStatus solve(const SearchLimits& limits) override { return board.solve(limits); }
+        int getValue(int row, int col) const override { return board.getValue(row, col); }
+        uint64_t nodeCount() const override { return board.nodeCount(); }
+        using SudokuSolver::countSolutions;
+        SolutionCount countSolutions(uint64_t limit, const SearchLimits& limits) override
+        {
+            return board.countSolutions(limit, limits);
+        }
+        void setProfile(const PropagationProfile& p) override { board.setProfile(p); }
+        void setValueOrder(ValueOrder order) override { board.setValueOrder(order); }
+        void setThreads(int count) override { board.setThreads(count); }
+
+    private:
+        SudokuBoard board;
+    };
+
+    // Propagation with a node budget; past it the puzzle goes to the SAT engine, which
+    // starts over on the same givens. Calls aborted by the caller's limits resume where
+    // they stopped, in whichever engine was running.
+    class PortfolioSolver : public SudokuSolver
+    {
+    public:
+        PortfolioSolver(int boardSize, uint64_t escalationNodes)
+            : propagation(boardSize), sat(boardSize), budget(std::max<uint64_t>(escalationNodes, 1)) {}
+
+        int size() const override { return propagation.size(); }
+        BoardError load(const std::string& puzzle) override
+        {
+            escalated = false;
+            used = 0;
+            givens = puzzle; // the SAT engine only loads it on escalation
+            return propagation.load(puzzle);
+        }
+        bool isConsistent() const override { return propagation.isConsistent(); }
+        SearchStatus solve(const SearchLimits& limits) override;
+        int getValue(int row, int col) const override
+        {
+            return escalated ? sat.getValue(row, col) : propagation.getValue(row, col);
+        }
+        uint64_t nodeCount() const override { return used + (escalated ? sat.nodeCount() : 0); }
+        using SudokuSolver::countSolutions;
+        SolutionCount countSolutions(uint64_t limit, const SearchLimits& limits) override
+        {
+            escalated = false; // the count runs on the propagation board, which getValue then reads
+            return propagation.countSolutions(limit, limits);
+        }
+        void setProfile(const PropagationProfile& p) override
+        {
+            propagation.setProfile(p);
+            sat.setProfile(p);
+        }
+        void setValueOrder(ValueOrder order) override { propagation.setValueOrder(order); }
+        void setThreads(int count) override
+        {
+            propagation.setThreads(count);
+            threads = std::max(count, 1);
+        }
+
+    private:
+        uint64_t escalationBudget() const
+        {
+            return threads > 1 ? BasicSudokuBoard<3>::parallelAfterNodes + budget * threads : budget;
+        }
+
+        PropagationSolver propagation;
+        SatSudokuSolver sat;
+        uint64_t budget;
+        int threads = 1;
+        uint64_t used = 0; // propagation nodes spent on the loaded puzzle
+        bool escalated = false;
+        std::string givens;
+    };
+
+    SearchStatus PortfolioSolver::solve(const SearchLimits& limits)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        SearchLimits rest = limits;
+
+        const uint64_t cap = escalationBudget();
+        if (!escalated && used < cap)
+        {
+            SearchLimits first = limits;
+            const uint64_t left = cap - used;
+            first.maxNodes = limits.maxNodes ? std::min(limits.maxNodes, left) : left;
+
+            SearchStatus status = propagation.solve(first);
+            used = propagation.nodeCount();
+            if (status != SearchStatus::Aborted || used < cap)
+                return status; // done, or stopped by the caller's limits
+        }
+        if (!escalated)
+        {
+            escalated = true;
+            sat.load(givens);
+            if (limits.maxTime.count() > 0)
+            {
+                rest.maxTime -= std::chrono::steady_clock::now() - start;
+                if (rest.maxTime.count() <= 0) return SearchStatus::Aborted;
+            }
+        }
+        return sat.solve(rest);
+    }
+
+    // Several differently configured searches of the same puzzle, one thread each; the first
+    // to solve or refute it wins and the others are cancelled through the cancel flag their
+    // search polls once per node. The first configuration, which setProfile and setValueOrder
+    // change, runs alone until raceAfterNodes. The others vary in value order, backjumping,
+    // rule profile and random tie-breaking. Aborted races resume, each search where it stopped.
+    class RaceSolver : public SudokuSolver
+    {
+    public:
+        static constexpr int maxRacers = 8;
+
+        explicit RaceSolver(int boardSize);
+
+        int size() const override { return racers[0].size(); }
+        BoardError load(const std::string& puzzle) override;
+        bool isConsistent() const override { return racers[0].isConsistent(); }
+        SearchStatus solve(const SearchLimits& limits) override;
+        int getValue(int row, int col) const override { return racers[winner].getValue(row, col); }
+        uint64_t nodeCount() const override;
+        using SudokuSolver::countSolutions;
+        SolutionCount countSolutions(uint64_t limit, const SearchLimits& limits) override
+        {
+            winner = 0;
+            return racers[0].countSolutions(limit, limits);
+        }
+        void setProfile(const PropagationProfile& p) override { racers[0].setProfile(p); }
+        void setValueOrder(ValueOrder order) override { racers[0].setValueOrder(order); }
+        void setThreads(int count) override { active = std::clamp(count, 1, maxRacers); }
+
+    private:
+        std::vector<SudokuBoard> racers;
+        int active; // racers used, the calling thread's included
+        int winner = 0;
+        int racing = 0; // racers in the race on the loaded puzzle; 0 during the solo start
+        std::string givens;
+
+        void addRacer(); // the next configuration
+    };
+
+    RaceSolver::RaceSolver(int boardSize)
+    {
+        racers.reserve(maxRacers);
+        racers.emplace_back(boardSize); // the others are built when a puzzle first needs a race
+        const int hardware = (int)std::thread::hardware_concurrency();
+        active = std::clamp(hardware, 2, 4);
+    }
+
+    void RaceSolver::addRacer()
+    {
+        const int k = (int)racers.size();
+        const int n = racers[0].size();
+        SudokuBoard& racer = racers.emplace_back(n);
+        if (k == 1)
+        {
+            racer.setValueOrder(n == 16 ? ValueOrder::Ascending : ValueOrder::LeastConstraining);
+            racer.setBackjumping(true);
+        }
+        else if (k == 2)
+        {
+            racer.setProfile(*PropagationProfile::named("full", n));
+        }
+        else
+        {
+            racer.setValueOrder(ValueOrder::Random, k - 2);
+        }
+    }
+
+    BoardError RaceSolver::load(const std::string& puzzle)
+    {
+        winner = 0;
+        racing = 0;
+        givens = puzzle; // the other racers only load it when the race starts
+        return racers[0].load(puzzle);
+    }
+
+    uint64_t RaceSolver::nodeCount() const
+    {
+        uint64_t total = racers[0].nodeCount();
+        for (int k = 1; k < racing; ++k)
+            total += racers[k].nodeCount();
+        return total;
+    }
+
+    SearchStatus RaceSolver::solve(const SearchLimits& limits)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        const uint64_t startNodes = racers[0].nodeCount();
+
+        if (!racing)
+        {
+            winner = 0;
+            if (active == 1) return racers[0].solve(limits);
+            SearchLimits solo = limits;
+            solo.maxNodes = limits.maxNodes ? std::min(limits.maxNodes, raceAfterNodes) : raceAfterNodes;
+            const SearchStatus status = racers[0].solve(solo);
+            const uint64_t used = racers[0].nodeCount() - startNodes;
+            if (status != SearchStatus::Aborted || used < raceAfterNodes || (limits.maxNodes && used >= limits.maxNodes))
+                return status;
+            racing = active;
+            while ((int)racers.size() < racing)
+                addRacer();
+            for (int k = 1; k < racing; ++k)
+                racers[k].load(givens);
+        }
+
+        SearchLimits shared = limits;
+        if (limits.maxTime.count() > 0)
+        {
+            shared.maxTime -= std::chrono::steady_clock::now() - start;
+            if (shared.maxTime.count() <= 0) return SearchStatus::Aborted;
+        }
+        std::atomic<bool> stop{false};
+        shared.cancel = &stop;
+
+        std::atomic<int> first{-1};
+        SearchStatus result = SearchStatus::Aborted;
+        auto finish = [&](int k, SearchStatus status)
+        {
+            int none = -1;
+            if (status == SearchStatus::Aborted || !first.compare_exchange_strong(none, k)) return;
+            result = status;
+            stop = true;
+        };
+
+        std::vector<std::thread> threads;
+        for (int k = 1; k < racing; ++k)
+            threads.emplace_back([&, k] { finish(k, racers[k].solve(shared)); });
+
+        // the calling thread runs the first configuration in slices, watching the caller's limits
+        SearchLimits slice;
+        slice.maxNodes = 256;
+        slice.cancel = &stop;
+        for (;;)
+        {
+            const SearchStatus status = racers[0].solve(slice);
+            if (status != SearchStatus::Aborted)
+            {
+                finish(0, status);
+                break;
+            }
+            if (stop) break;
+            const bool cancelled = limits.cancel && limits.cancel->load(std::memory_order_relaxed);
+            const bool overNodes = limits.maxNodes && racers[0].nodeCount() - startNodes >= limits.maxNodes;
+            const bool overTime = limits.maxTime.count() > 0 && std::chrono::steady_clock::now() - start >= limits.maxTime;
+            if (cancelled || overNodes || overTime)
+            {
+                stop = true;
+                break;
+            }
+        }
+        for (std::thread& thread : threads)
+            thread.join();
+
+        if (first >= 0) winner = first;
+        return result;
+    }
+}
+
+std::optional<Engine> engineFromName(const std::string& name)
+{
+    if (name == "propagation") return Engine::Propagation;
+    if (name == "dlx") return Engine::Dlx;
+    if (name == "sat") return Engine::Sat;
+    if (name == "portfolio") return Engine::Portfolio;
+    if (name == "race") return Engine::Race;
+    return std::nullopt;
+}
+
+const char* engineName(Engine engine)
+{
+    switch (engine)
+    {
+        case Engine::Propagation: return "propagation";
+        case Engine::Dlx:         return "dlx";
+        case Engine::Sat:         return "sat";
+        case Engine::Portfolio:   return "portfolio";
+        case Engine::Race:        return "race";
+    }
+    return "unknown";
+}
+
+std::string boardString(const SudokuSolver& solver)
+{
+    const int n = solver.size();
+    std::string result;
+    result.reserve(n * n);
+    for (int r = 0; r < n; ++r)
+        for (int c = 0; c < n; ++c)
+        {
+            const int value = solver.getValue(r, c);
+            result += value <= 9 ? char('0' + value) : char('A' + value - 10);
+        }
+    return result;
+}
+
+std::unique_ptr<SudokuSolver> makeSolver(Engine engine, int boardSize, uint64_t escalationNodes)
+{
+    if (!SudokuBoard::isSupportedSize(boardSize))
+        throw std::invalid_argument("Board size must be 9, 16 or 25.");
+
+    switch (engine)
+    {
+        case Engine::Dlx:       return std::make_unique<DlxSolver>(boardSize);
+        case Engine::Sat:       return std::make_unique<SatSudokuSolver>(boardSize);
+        case Engine::Portfolio:
+            return std::make_unique<PortfolioSolver>(boardSize, escalationNodes ? escalationNodes : defaultEscalationNodes(boardSize));
+        case Engine::Race:      return std::make_unique<RaceSolver>(boardSize);
+        default:                return std::make_unique<PropagationSolver>(boardSize);
+    }
+}
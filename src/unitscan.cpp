@@ -0,0 +1,163 @@
+#include "unitscan.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#ifdef SUDOKU_UNITSCAN_AVX2
+namespace unitscanAvx2
+{
+    UnitScan scan(const uint16_t* masks, int n);
+    UnitScan scan(const uint32_t* masks, int n);
+}
+#endif
+
+namespace
+{
+    template <typename Mask>
+    UnitScan scanPortable(const Mask* masks, int n)
+    {
+        UnitScan out;
+        for (int p = 0; p < n; ++p)
+        {
+            const Mask m = masks[p];
+            if (m) out.seen |= 1u << p;
+            if (m && !(m & (m - 1))) out.once |= 1u << p;
+        }
+        return out;
+    }
+
+#if defined(__SSE2__)
+    UnitScan scanSse2(const uint16_t* masks, int n)
+    {
+        UnitScan out;
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i one = _mm_set1_epi16(1);
+        int p = 0;
+        for (; p + 8 <= n; p += 8)
+        {
+            const __m128i m = _mm_loadu_si128(reinterpret_cast<const __m128i*>(masks + p));
+            const __m128i none = _mm_cmpeq_epi16(m, zero);
+            const __m128i atMostOne = _mm_cmpeq_epi16(_mm_and_si128(m, _mm_sub_epi16(m, one)), zero);
+            const uint32_t bits = (uint32_t)_mm_movemask_epi8(_mm_packs_epi16(none, atMostOne)); // low 8: none
+            const uint32_t seen = ~bits & 0xFF;
+            out.seen |= seen << p;
+            out.once |= ((bits >> 8) & seen) << p;
+        }
+        const UnitScan tail = scanPortable(masks + p, n - p);
+        out.seen |= tail.seen << p;
+        out.once |= tail.once << p;
+        return out;
+    }
+
+    UnitScan scanSse2(const uint32_t* masks, int n)
+    {
+        UnitScan out;
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i one = _mm_set1_epi32(1);
+        int p = 0;
+        for (; p + 4 <= n; p += 4)
+        {
+            const __m128i m = _mm_loadu_si128(reinterpret_cast<const __m128i*>(masks + p));
+            const uint32_t none = (uint32_t)_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(m, zero)));
+            const __m128i rest = _mm_and_si128(m, _mm_sub_epi32(m, one));
+            const uint32_t atMostOne = (uint32_t)_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(rest, zero)));
+            out.seen |= (~none & 0xF) << p;
+            out.once |= (atMostOne & ~none & 0xF) << p;
+        }
+        const UnitScan tail = scanPortable(masks + p, n - p);
+        out.seen |= tail.seen << p;
+        out.once |= tail.once << p;
+        return out;
+    }
+#endif
+
+    template <typename Mask>
+    UnitScan scanWith(const Mask* masks, int n, ScanIsa isa)
+    {
+        switch (isa)
+        {
+#ifdef SUDOKU_UNITSCAN_AVX2
+            case ScanIsa::Avx2: return unitscanAvx2::scan(masks, n);
+#endif
+#if defined(__SSE2__)
+            case ScanIsa::Sse2: return scanSse2(masks, n);
+#endif
+            default:            return scanPortable(masks, n);
+        }
+    }
+
+    template <typename Mask>
+    using ScanFn = UnitScan (*)(const Mask*, int);
+
+    template <typename Mask>
+    ScanFn<Mask> pick()
+    {
+        switch (bestScanIsa())
+        {
+#ifdef SUDOKU_UNITSCAN_AVX2
+            case ScanIsa::Avx2: return unitscanAvx2::scan;
+#endif
+#if defined(__SSE2__)
+            case ScanIsa::Sse2: return scanSse2;
+#endif
+            default:            return scanPortable<Mask>;
+        }
+    }
+}
+
+bool scanIsaSupported(ScanIsa isa)
+{
+    switch (isa)
+    {
+        case ScanIsa::Portable: return true;
+#if defined(__SSE2__)
+        case ScanIsa::Sse2:     return true;
+#endif
+#ifdef SUDOKU_UNITSCAN_AVX2
+        case ScanIsa::Avx2:     return __builtin_cpu_supports("avx2");
+#endif
+        default:                return false;
+    }
+}
+
+ScanIsa bestScanIsa()
+{
+    static const ScanIsa best = scanIsaSupported(ScanIsa::Avx2) ? ScanIsa::Avx2
+                              : scanIsaSupported(ScanIsa::Sse2) ? ScanIsa::Sse2
+                                                                : ScanIsa::Portable;
+    return best;
+}
+
+const char* scanIsaName(ScanIsa isa)
+{
+    switch (isa)
+    {
+        case ScanIsa::Portable: return "portable";
+        case ScanIsa::Sse2:     return "sse2";
+        case ScanIsa::Avx2:     return "avx2";
+    }
+    return "unknown";
+}
+
+UnitScan scanUnit(const uint16_t* masks, int n)
+{
+    static const ScanFn<uint16_t> scan = pick<uint16_t>();
+    return scan(masks, n);
+}
+
+UnitScan scanUnit(const uint32_t* masks, int n)
+{
+    static const ScanFn<uint32_t> scan = pick<uint32_t>();
+    return scan(masks, n);
+}
+
+UnitScan scanUnit(const uint16_t* masks, int n, ScanIsa isa)
+{
+    return scanWith(masks, n, scanIsaSupported(isa) ? isa : bestScanIsa());
+}
+
+UnitScan scanUnit(const uint32_t* masks, int n, ScanIsa isa)
+{
+    return scanWith(masks, n, scanIsaSupported(isa) ? isa : bestScanIsa());
+}
@@ -0,0 +1,71 @@
+// unitscan_avx2.cpp
+// The AVX2 unit scans, built with -mavx2 (see CMakeLists.txt); only called on CPUs that have it.
+// Empty when built without the flag, so a plain build of src/*.cpp still compiles.
+#if defined(__AVX2__)
+#include "unitscan.h"
+#include <immintrin.h>
+
+namespace unitscanAvx2
+{
+    UnitScan scan(const uint16_t* masks, int n)
+    {
+        UnitScan out;
+        int p = 0;
+        if (n >= 16)
+        {
+            const __m256i m = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(masks));
+            const __m256i zero = _mm256_setzero_si256();
+            const __m256i none = _mm256_cmpeq_epi16(m, zero);
+            const __m256i atMostOne = _mm256_cmpeq_epi16(_mm256_and_si256(m, _mm256_sub_epi16(m, _mm256_set1_epi16(1))), zero);
+            // pack the 16-bit lanes to bytes; packs works per 128-bit half, so put the halves back in order
+            const __m256i packed = _mm256_permute4x64_epi64(_mm256_packs_epi16(none, atMostOne), 0xD8);
+            const uint32_t bits = (uint32_t)_mm256_movemask_epi8(packed); // low 16: none, high 16: at most one
+            out.seen = ~bits & 0xFFFF;
+            out.once = (bits >> 16) & out.seen;
+            p = 16;
+        }
+        else if (n >= 8)
+        {
+            const __m128i m = _mm_loadu_si128(reinterpret_cast<const __m128i*>(masks));
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i none = _mm_cmpeq_epi16(m, zero);
+            const __m128i atMostOne = _mm_cmpeq_epi16(_mm_and_si128(m, _mm_sub_epi16(m, _mm_set1_epi16(1))), zero);
+            const uint32_t bits = (uint32_t)_mm_movemask_epi8(_mm_packs_epi16(none, atMostOne));
+            out.seen = ~bits & 0xFF;
+            out.once = (bits >> 8) & out.seen;
+            p = 8;
+        }
+        for (; p < n; ++p)
+        {
+            const uint16_t m = masks[p];
+            if (m) out.seen |= 1u << p;
+            if (m && !(m & (m - 1))) out.once |= 1u << p;
+        }
+        return out;
+    }
+
+    UnitScan scan(const uint32_t* masks, int n)
+    {
+        UnitScan out;
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i one = _mm256_set1_epi32(1);
+        int p = 0;
+        for (; p + 8 <= n; p += 8)
+        {
+            const __m256i m = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(masks + p));
+            const uint32_t none = (uint32_t)_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(m, zero)));
+            const __m256i rest = _mm256_and_si256(m, _mm256_sub_epi32(m, one));
+            const uint32_t atMostOne = (uint32_t)_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(rest, zero)));
+            out.seen |= (~none & 0xFF) << p;
+            out.once |= (atMostOne & ~none & 0xFF) << p;
+        }
+        for (; p < n; ++p)
+        {
+            const uint32_t m = masks[p];
+            if (m) out.seen |= 1u << p;
+            if (m && !(m & (m - 1))) out.once |= 1u << p;
+        }
+        return out;
+    }
+}
+#endif
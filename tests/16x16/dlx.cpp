@@ -0,0 +1,51 @@
+#include "../helpers.h"
+#include "solver.h"
+#include <cassert>
+#include <iostream>
+#include <string>
+
+// every row, column and box holds 1..16 once, and the givens are kept
+static bool validSolution(const SudokuSolver& solver, const std::string& puzzle)
+{
+    for (int i = 0; i < 16; ++i)
+    {
+        int rowSeen = 0, colSeen = 0, boxSeen = 0;
+        for (int j = 0; j < 16; ++j)
+        {
+            int r = (i / 4) * 4 + j / 4, c = (i % 4) * 4 + j % 4;
+            rowSeen |= 1 << solver.getValue(i, j);
+            colSeen |= 1 << solver.getValue(j, i);
+            boxSeen |= 1 << solver.getValue(r, c);
+
+            char ch = puzzle[i * 16 + j];
+            int given = ch == '0' || ch == '.' ? 0 : ch <= '9' ? ch - '0' : ch - 'A' + 10;
+            if (given != 0 && given != solver.getValue(i, j))
+                return false;
+        }
+        if (rowSeen != 0x1FFFE || colSeen != 0x1FFFE || boxSeen != 0x1FFFE)
+            return false;
+    }
+    return true;
+}
+
+int main()
+{
+    for (const char* name : { "easy", "medium", "hard" })
+    {
+        std::string puzzle = readPuzzle(std::string("boards/16x16/") + name + ".txt");
+        auto dlx = makeSolver(Engine::Dlx, 16);
+        assert(dlx->load(puzzle) == BoardError::None);
+        assert(dlx->solve() == SearchStatus::Solved);
+        assert(validSolution(*dlx, puzzle));
+        std::cout << name << ": " << dlx->nodeCount() << " DLX nodes\n";
+
+        // medium and hard have several solutions; both engines see the same count
+        auto propagation = makeSolver(Engine::Propagation, 16);
+        propagation->load(puzzle);
+        dlx->load(puzzle);
+        assert(dlx->countSolutions(3) == propagation->countSolutions(3));
+    }
+
+    std::cout << "[OK] 16x16 DLX engine test passed\n";
+    return 0;
+}
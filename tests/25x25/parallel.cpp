@@ -0,0 +1,194 @@
+#include "solver.h"
+#include <atomic>
+#include <cassert>
+#include <iostream>
+#include <string>
+
+// a satisfiable board that takes about 2200 search nodes
+static const std::string deep =
+    "BJA.C..7.3.1.LF.H..N4PK69"
+    "K.4...AB.M5..N....3.DGF1L"
+    "..O..NHE8.......D.GLAMB.C"
+    "F....94K..3...7BAJMC...8N"
+    "...5.L.F...JA.B...P9...2."
+    ".K..D...B62.3.I..7J..8.FH"
+    "..58.DG..1J..A....643.I.O"
+    "C..JA....2.K....5...P...4"
+    "..P64....J8F..N....O.1L.."
+    "I..2O.5N..6.P49LG.1DMJ..A"
+    "M...J2...N94K.G5F.....P.6"
+    "..E.2.F5DLC.B6PG..9.7I..."
+    "...916BP...H.23.7OI..L5.."
+    ".ABC6J..O.L.F8.3.HN2.9G.1"
+    ".DFL81KG49IO7J.PB.C6.N.H."
+    "H..F5.1D..7I....6CBP2.O.."
+    ".......ON.K.....8.....4.P"
+    "..1..P..C.EN..OAJ.7.8FHL."
+    "ON2.3...L......D..KG.7.I."
+    "4....M...7....H..NE.1...."
+    ".M.AB.I.3OD.L.82.5..941.."
+    "1.9.K....A.5.E.JI3.7...G."
+    ".5.H....GD.MC.....4.IO..7"
+    "J..O7EN2..4..K..LG..C.6.B"
+    "8.L..K....O3I7..C..BNH25."
+    ;
+
+// an unsolvable board that search refutes in about 4300 nodes
+static const std::string refuted =
+    "2..P..4L...8.BM.AG.....7."
+    "...MK...7.O..4.J.2..I.E.."
+    "7.3.FJH......A9.4CL.6..8."
+    ".AI9..B.8.J.1...D.FN..L.5"
+    "C..5.I...937..N.B..M.H12P"
+    "9G.K....M.HP.2..7N.1....E"
+    "P.HL....5E.M68..G9..D.3N."
+    "M.BF6D7...4...E..PJL..I9."
+    "...13H..PL..I......EB8.M."
+    ".C4EO.....D...1..M6.....L"
+    ".......BF.2.....N1...5.EI"
+    "F.83..ND1J.E45I2P...G9.K."
+    "1..J..PHLOGK.9....4I8MB.3"
+    "L.2.HC.4EI...M..9K...NJ.."
+    ".5...G..K.7..NJ8.F......O"
+    ".IE.5K6.B8...J.F........C"
+    "HJ.2NLO.4C...68.IA.GF3.D7"
+    ".O.C..I...F..37K.B98.J..2"
+    "D.F7M.JN..EA.I.L.4..K.9B8"
+    "..K.9F3.D..4PO...H.2.I5.."
+    "..MD8N1.JH...E..L....KG6."
+    "OL.42..CI..3.FD9...BN1..."
+    "J1N.7PL2...6GK.5.I.AM.83D"
+    "..5AC9K.6BN..1..F3..PL2.."
+    ".K9...F8.D..2...1J..5E.IA"
+    ;
+
+template <typename Board>
+static bool keepsGivens(const Board& board, const std::string& puzzle)
+{
+    for (int i = 0; i < 625; ++i)
+    {
+        const char ch = puzzle[i];
+        const int given = ch == '.' ? 0 : ch <= '9' ? ch - '0' : ch - 'A' + 10;
+        if (given != 0 && board.getValue(i / 25, i % 25) != given)
+            return false;
+    }
+    return true;
+}
+
+int main()
+{
+    for (int threads : { 2, 4, 8 })
+    {
+        SudokuBoard board(25);
+        board.setThreads(threads);
+
+        assert(board.load(deep) == BoardError::None);
+        assert(board.solve(SearchLimits{}) == SearchStatus::Solved);
+        assert(board.isSolved() && keepsGivens(board, deep));
+        assert(board.nodeCount() > 1000); // past the serial start
+
+        assert(board.load(refuted) == BoardError::None);
+        assert(board.solve(SearchLimits{}) == SearchStatus::Unsolvable);
+    }
+
+    // a parallel search stopped by the caller resumes on the next solve, on any number of threads
+    SudokuBoard board(25);
+    board.setThreads(4);
+    board.load(refuted);
+    SearchLimits limits;
+    limits.maxNodes = 2000;
+    assert(board.solve(limits) == SearchStatus::Aborted);
+    assert(board.solve(SearchLimits{}) == SearchStatus::Unsolvable);
+
+    board.load(refuted);
+    limits.maxNodes = 1500;
+    SearchStatus capped;
+    int calls = 0;
+    for (int threads = 4; (capped = board.solve(limits)) == SearchStatus::Aborted; threads = threads % 4 + 1)
+    {
+        assert(++calls < 50); // every call gets further
+        board.setThreads(threads);
+    }
+    assert(capped == SearchStatus::Unsolvable && calls > 1);
+    board.setThreads(4);
+
+    std::atomic<bool> cancel{true};
+    limits = {};
+    limits.cancel = &cancel;
+    board.load(deep);
+    assert(board.solve(limits) == SearchStatus::Aborted);
+    cancel = false;
+    assert(board.solve(limits) == SearchStatus::Solved);
+    assert(board.isSolved());
+
+    // the portfolio's propagation stage takes the threads, with the default budget too, and its
+    // capped calls resume
+    SudokuBoard root(25);
+    root.load(refuted);
+    root.propagateAll();
+    for (int threads : { 1, 4 })
+    {
+        auto portfolio = makeSolver(Engine::Portfolio, 25);
+        portfolio->setThreads(threads);
+
+        assert(portfolio->load(deep) == BoardError::None);
+        assert(portfolio->solve() == SearchStatus::Solved);
+        assert(keepsGivens(*portfolio, deep));
+
+        portfolio->load(refuted);
+        SearchLimits few;
+        few.maxNodes = 1500;
+        SearchStatus status = portfolio->solve(few);
+        if (threads > 1)
+        {
+            // past the serial start without escalating: an aborted parallel search shows the root
+            assert(status == SearchStatus::Aborted);
+            for (int r = 0; r < 25; ++r)
+                for (int c = 0; c < 25; ++c)
+                    assert(portfolio->getValue(r, c) == root.getValue(r, c));
+        }
+        int portfolioCalls = 0;
+        while (status == SearchStatus::Aborted)
+        {
+            assert(++portfolioCalls < 50);
+            status = portfolio->solve(few);
+        }
+        assert(status == SearchStatus::Unsolvable);
+    }
+
+    // racing configurations: the first answer comes back through the solver interface
+    for (int threads : { 1, 2, 4 })
+    {
+        auto race = makeSolver(Engine::Race, 25);
+        race->setThreads(threads);
+
+        assert(race->load(deep) == BoardError::None);
+        assert(race->solve() == SearchStatus::Solved);
+        assert(keepsGivens(*race, deep));
+        for (int i = 0; i < 25; ++i)
+        {
+            uint32_t rowSeen = 0, colSeen = 0;
+            for (int j = 0; j < 25; ++j)
+            {
+                rowSeen |= 1u << (race->getValue(i, j) - 1);
+                colSeen |= 1u << (race->getValue(j, i) - 1);
+            }
+            assert(rowSeen == 0x1FFFFFF && colSeen == 0x1FFFFFF);
+        }
+
+        race->load(refuted);
+        assert(race->solve() == SearchStatus::Unsolvable);
+
+        // stopped by the caller, the race resumes where every search stopped
+        race->load(refuted);
+        SearchLimits few;
+        few.maxNodes = 1500;
+        SearchStatus status = race->solve(few);
+        while (status == SearchStatus::Aborted)
+            status = race->solve(few);
+        assert(status == SearchStatus::Unsolvable);
+    }
+
+    std::cout << "[OK] 25x25 parallel search test passed\n";
+    return 0;
+}
@@ -0,0 +1,31 @@
+#include "../helpers.h"
+#include "solver.h"
+#include <cassert>
+#include <iostream>
+#include <string>
+
+int main()
+{
+    for (const char* name : { "easy", "medium", "hard" })
+    {
+        std::string puzzle = readPuzzle(std::string("boards/25x25/") + name + ".txt");
+        auto sat = makeSolver(Engine::Sat, 25);
+        assert(sat->load(puzzle) == BoardError::None);
+        assert(sat->solve() == SearchStatus::Solved);
+
+        // every row and column holds 1..25 once
+        for (int i = 0; i < 25; ++i)
+        {
+            uint32_t rowSeen = 0, colSeen = 0;
+            for (int j = 0; j < 25; ++j)
+            {
+                rowSeen |= 1u << (sat->getValue(i, j) - 1);
+                colSeen |= 1u << (sat->getValue(j, i) - 1);
+            }
+            assert(rowSeen == 0x1FFFFFF && colSeen == 0x1FFFFFF);
+        }
+    }
+
+    std::cout << "[OK] 25x25 SAT engine test passed\n";
+    return 0;
+}
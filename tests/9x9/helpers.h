@@ -0,0 +1,29 @@
+#pragma once
+// helpers.h
+// Shared by the 9x9 tests: boards back as strings, and puzzles with fewer givens.
+
+#include <string>
+#include "../helpers.h"
+
+// the board's 81 values, '0' for empty cells; for SudokuBoard and SudokuSolver alike
+template <typename Board>
+std::string solutionOf(const Board& board)
+{
+    std::string solution;
+    for (int r = 0; r < 9; ++r)
+        for (int c = 0; c < 9; ++c)
+            solution += char('0' + board.getValue(r, c));
+    return solution;
+}
+
+// the puzzle with its first `count` givens taken out, so it has more solutions to count
+inline std::string withoutGivens(std::string puzzle, int count)
+{
+    for (int i = 0, dropped = 0; i < 81 && dropped < count; ++i)
+        if (puzzle[i] != '0' && puzzle[i] != '.')
+        {
+            puzzle[i] = '0';
+            ++dropped;
+        }
+    return puzzle;
+}
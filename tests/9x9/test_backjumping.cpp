@@ -0,0 +1,62 @@
+#include "helpers.h"
+#include "sudoku.h"
+#include <cassert>
+#include <iostream>
+#include <string>
+
+// the same search with and without backjumping, under both undo strategies
+static void compare(const std::string& puzzle, StateStrategy strategy)
+{
+    SudokuBoard plain(9), jumping(9);
+    plain.setStateStrategy(strategy);
+    jumping.setStateStrategy(strategy);
+    jumping.setBackjumping(true);
+
+    assert(plain.load(puzzle) == BoardError::None);
+    assert(jumping.load(puzzle) == BoardError::None);
+    SearchStatus expected = plain.solve(SearchLimits{});
+    assert(jumping.solve(SearchLimits{}) == expected);
+    assert(jumping.nodeCount() <= plain.nodeCount());
+    if (expected == SearchStatus::Solved)
+        for (int r = 0; r < 9; ++r)
+            for (int c = 0; c < 9; ++c)
+                assert(jumping.getValue(r, c) == plain.getValue(r, c));
+
+    // counting goes on past every solution found
+    plain.load(puzzle);
+    jumping.load(puzzle);
+    assert(jumping.countSolutions(1000) == plain.countSolutions(1000));
+}
+
+int main()
+{
+    // a board that needs a few hundred search nodes
+    const std::string deep = readPuzzle("boards/9x9/deep.txt");
+
+    SudokuBoard board(9);
+    board.load(deep);
+    assert(board.solve(SearchLimits{}) == SearchStatus::Solved);
+    const std::string solution = solutionOf(board);
+
+    // one wrong given that propagation alone does not refute
+    std::string wrong = deep;
+    for (int i = 0; i < 81; ++i)
+        if (wrong[i] == '0')
+        {
+            wrong[i] = char('0' + (solution[i] - '0') % 9 + 1);
+            SudokuBoard probe(9);
+            if (probe.load(wrong) == BoardError::None && probe.propagateAll())
+                break;
+            wrong[i] = '0';
+        }
+
+    // fewer givens: many solutions to count
+    const std::string open = withoutGivens(deep, 3);
+
+    for (StateStrategy strategy : { StateStrategy::Trail, StateStrategy::Snapshot })
+        for (const std::string& puzzle : { deep, wrong, open })
+            compare(puzzle, strategy);
+
+    std::cout << "[OK] Backjumping test passed\n";
+    return 0;
+}
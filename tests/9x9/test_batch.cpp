@@ -0,0 +1,79 @@
+#include "batch.h"
+#include "helpers.h"
+#include <atomic>
+#include <cassert>
+#include <iostream>
+#include <string>
+#include <vector>
+
+int main()
+{
+    const std::string easy = readPuzzle("boards/9x9/easy.txt");
+    const std::string deep = readPuzzle("boards/9x9/deep.txt");
+    std::string duplicate = easy;
+    duplicate[1] = '5'; // a second 5 in the first row
+    std::string unsolvable = easy;
+    unsolvable[2] = '1'; // consistent givens, but the row can no longer be completed
+    const std::string shortBoard = easy.substr(1);
+
+    std::vector<std::string> puzzles;
+    for (int i = 0; i < 50; ++i)
+    {
+        puzzles.push_back(i % 2 ? easy : deep);
+        if (i % 10 == 3) puzzles.push_back(duplicate);
+        if (i % 10 == 5) puzzles.push_back(unsolvable);
+        if (i % 10 == 7) puzzles.push_back(shortBoard);
+    }
+
+    // each puzzle solved on its own
+    std::vector<BatchResult> expected;
+    for (const std::string& puzzle : puzzles)
+        expected.push_back(solveBatch(&puzzle, 1, 9).front());
+
+    for (Engine engine : { Engine::Propagation, Engine::Dlx, Engine::Portfolio })
+        for (int threads : { 1, 2, 4 })
+        {
+            BatchOptions options;
+            options.engine = engine;
+            options.threads = threads;
+            std::vector<BatchResult> results = solveBatch(puzzles, 9, options);
+            assert(results.size() == puzzles.size());
+            for (size_t i = 0; i < puzzles.size(); ++i)
+            {
+                assert(results[i].error == expected[i].error);
+                assert(results[i].status == expected[i].status);
+                assert(results[i].solution == expected[i].solution);
+            }
+        }
+
+    for (size_t i = 0; i < puzzles.size(); ++i)
+    {
+        if (puzzles[i] == duplicate) assert(expected[i].error == BoardError::Conflict);
+        else if (puzzles[i] == shortBoard) assert(expected[i].error == BoardError::BadLength);
+        else if (puzzles[i] == unsolvable) assert(expected[i].status == SearchStatus::Unsolvable);
+        else
+        {
+            assert(expected[i].status == SearchStatus::Solved);
+            assert(expected[i].solution.size() == 81 && expected[i].solution.find('0') == std::string::npos);
+            for (size_t k = 0; k < 81; ++k)
+                assert(puzzles[i][k] == '.' || puzzles[i][k] == '0' || puzzles[i][k] == expected[i].solution[k]);
+        }
+    }
+
+    // a raised cancel flag aborts whatever has not been solved; bad input still says what is wrong
+    std::atomic<bool> cancel{true};
+    BatchOptions cancelled;
+    cancelled.limits.cancel = &cancel;
+    const std::vector<BatchResult> aborted = solveBatch(puzzles, 9, cancelled);
+    for (size_t i = 0; i < puzzles.size(); ++i)
+    {
+        assert(aborted[i].error == expected[i].error);
+        if (expected[i].error == BoardError::None)
+            assert(aborted[i].status == SearchStatus::Aborted);
+    }
+
+    assert(solveBatch(std::vector<std::string>{}, 9).empty());
+
+    std::cout << "[OK] Batch solve test passed\n";
+    return 0;
+}
@@ -0,0 +1,106 @@
+#include "helpers.h"
+#include "solver.h"
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <string>
+
+// every row, column and box holds 1..9 once, and the givens are kept
+static bool validSolution(const SudokuSolver& solver, const std::string& puzzle)
+{
+    for (int i = 0; i < 9; ++i)
+    {
+        int rowSeen = 0, colSeen = 0, boxSeen = 0;
+        for (int j = 0; j < 9; ++j)
+        {
+            int r = (i / 3) * 3 + j / 3, c = (i % 3) * 3 + j % 3;
+            rowSeen |= 1 << solver.getValue(i, j);
+            colSeen |= 1 << solver.getValue(j, i);
+            boxSeen |= 1 << solver.getValue(r, c);
+            if (puzzle[i * 9 + j] != '0' && puzzle[i * 9 + j] - '0' != solver.getValue(i, j))
+                return false;
+        }
+        if (rowSeen != 0x3FE || colSeen != 0x3FE || boxSeen != 0x3FE)
+            return false;
+    }
+    return true;
+}
+
+int main()
+{
+    for (const char* name : { "easy", "medium", "hard" })
+    {
+        std::string puzzle = readPuzzle(std::string("boards/9x9/") + name + ".txt");
+        auto dlx = makeSolver(Engine::Dlx, 9);
+        assert(dlx->load(puzzle) == BoardError::None);
+        assert(dlx->solve() == SearchStatus::Solved);
+        assert(validSolution(*dlx, puzzle));
+
+        // both engines agree on the (unique) solution
+        auto propagation = makeSolver(Engine::Propagation, 9);
+        assert(propagation->load(puzzle) == BoardError::None);
+        assert(propagation->solve() == SearchStatus::Solved);
+        for (int r = 0; r < 9; ++r)
+            for (int c = 0; c < 9; ++c)
+                assert(dlx->getValue(r, c) == propagation->getValue(r, c));
+    }
+
+    // duplicate givens load but have no solution
+    auto dlx = makeSolver(Engine::Dlx, 9);
+    std::string unsolvable = readPuzzle("boards/9x9/unsolvable.txt");
+    assert(dlx->load(unsolvable) == BoardError::None);
+    assert(!dlx->isConsistent());
+    assert(dlx->solve() == SearchStatus::Unsolvable);
+    assert(dlx->countSolutions(2) == 0);
+
+    // solution counting: a proper puzzle has one, dropping givens opens up more
+    std::string hard = readPuzzle("boards/9x9/hard.txt");
+    std::string loose = hard;
+    for (int i = 0, dropped = 0; i < 81 && dropped < 4; ++i)
+        if (loose[i] != '0') { loose[i] = '0'; ++dropped; }
+
+    for (Engine engine : { Engine::Dlx, Engine::Propagation })
+    {
+        auto solver = makeSolver(engine, 9);
+        solver->load(hard);
+        assert(solver->countSolutions(2) == 1);
+        solver->load(loose);
+        assert(solver->countSolutions(2) == 2);
+        solver->load(std::string(81, '0'));
+        assert(solver->countSolutions(10) == 10);
+    }
+
+    // a bounded count stops early and says so; a count within its limits is complete
+    for (Engine engine : { Engine::Dlx, Engine::Propagation, Engine::Sat, Engine::Portfolio, Engine::Race })
+    {
+        auto solver = makeSolver(engine, 9);
+        SearchLimits few;
+        few.maxNodes = 100;
+        solver->load(std::string(81, '0'));
+        SolutionCount partial = solver->countSolutions(1000, few);
+        assert(!partial.complete && partial.count < 1000);
+
+        solver->load(loose);
+        const uint64_t expected = solver->countSolutions(1000);
+        SearchLimits plenty;
+        plenty.maxNodes = 1000000;
+        plenty.maxTime = std::chrono::seconds(60);
+        solver->load(loose);
+        SolutionCount whole = solver->countSolutions(1000, plenty);
+        assert(whole.complete && whole.count == expected);
+    }
+
+    // a node budget aborts the search, which then resumes to the same solution
+    dlx->load(hard);
+    SearchLimits limits;
+    limits.maxNodes = 50;
+    SearchStatus status;
+    int calls = 0;
+    while ((status = dlx->solve(limits)) == SearchStatus::Aborted)
+        ++calls;
+    assert(status == SearchStatus::Solved && calls > 0);
+    assert(validSolution(*dlx, hard));
+
+    std::cout << "[OK] DLX engine test passed\n";
+    return 0;
+}
@@ -1,11 +1,22 @@
 #include "sudoku.h"
 #include <cassert>
 #include <iostream>
+#include <string>
 
 int main()
 {
     SudokuBoard board(9);
 
+    // a board that was never loaded, or whose load was rejected, is an empty grid
+    assert(!board.hasContradiction());
+    assert(board.countSolutions(10) == 10);
+    assert(board.load(std::string(80, '1')) == BoardError::BadLength);
+    assert(!board.hasContradiction());
+    for (int r = 0; r < 9; ++r)
+        for (int c = 0; c < 9; ++c)
+            assert(board.getValue(r, c) == 0);
+    assert(board.countSolutions(10) == 10);
+
     assert(board.loadFromFile("boards/9x9/easy.txt") && "Failed to load boards/easy.txt");
     assert(board.loadFromFile("boards/9x9/medium.txt") && "Failed to load boards/medium.txt");
     assert(board.loadFromFile("boards/9x9/hard.txt") && "Failed to load boards/hard.txt");
@@ -0,0 +1,80 @@
+#include "batch.h"
+#include "helpers.h"
+#include "lockstep.h"
+#include <cassert>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// the same puzzle with its digits renamed: a different puzzle of the same difficulty
+static std::string relabel(const std::string& puzzle, int shift)
+{
+    std::string out = puzzle;
+    for (char& ch : out)
+        if (ch >= '1' && ch <= '9')
+            ch = char('1' + (ch - '1' + shift) % 9);
+    return out;
+}
+
+int main()
+{
+    const std::string easy = readPuzzle("boards/9x9/easy.txt");
+    const std::string deep = readPuzzle("boards/9x9/deep.txt");
+    std::string duplicate = easy;
+    duplicate[1] = '5';
+    std::string unsolvable = easy;
+    unsolvable[2] = '1';
+
+    assert(laneReady(easy) && laneReady(deep));
+    assert(!laneReady(duplicate) && !laneReady(easy.substr(1)) && !laneReady(std::string(81, 'A')));
+
+    for (LaneIsa isa : { LaneIsa::Generic, LaneIsa::Avx2, LaneIsa::Avx512 })
+    {
+        assert(laneIsaFromName(laneIsaName(isa)) == isa);
+        if (!laneIsaSupported(isa))
+            continue;
+
+        // singles finish the easy puzzle, not the deep one, and refute the unsolvable one
+        std::string lanes[3] = { easy, deep, unsolvable };
+        assert(propagateLanes(lanes, 3, isa) == 0b100);
+        assert(lanes[0].find('0') == std::string::npos);
+        assert(lanes[1].find('0') != std::string::npos);
+        for (int id = 0; id < 81; ++id)
+        {
+            assert(easy[id] == '0' || lanes[0][id] == easy[id]);
+            assert(deep[id] == '0' || lanes[1][id] == deep[id]);
+        }
+    }
+
+    std::vector<std::string> puzzles;
+    for (int i = 0; i < 100; ++i)
+    {
+        puzzles.push_back(relabel(i % 3 ? easy : deep, i % 9));
+        if (i % 10 == 3) puzzles.push_back(duplicate);
+        if (i % 10 == 5) puzzles.push_back(relabel(unsolvable, i % 9));
+        if (i % 10 == 7) puzzles.push_back("12");
+    }
+
+    BatchOptions plain;
+    plain.lockstep = false;
+    const std::vector<BatchResult> expected = solveBatch(puzzles, 9, plain);
+
+    for (LaneIsa isa : { LaneIsa::Generic, LaneIsa::Avx2, LaneIsa::Avx512 })
+        for (int threads : { 1, 3 })
+        {
+            BatchOptions options;
+            options.laneIsa = isa;
+            options.threads = threads;
+            const std::vector<BatchResult> results = solveBatch(puzzles, 9, options);
+            assert(results.size() == expected.size());
+            for (size_t i = 0; i < results.size(); ++i)
+            {
+                assert(results[i].error == expected[i].error);
+                assert(results[i].status == expected[i].status);
+                assert(results[i].solution == expected[i].solution);
+            }
+        }
+
+    std::cout << "[OK] Lockstep batch test passed (" << laneIsaName(bestLaneIsa()) << ")\n";
+    return 0;
+}
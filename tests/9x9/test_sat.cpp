@@ -0,0 +1,78 @@
+#include "helpers.h"
+#include "solver.h"
+#include <cassert>
+#include <iostream>
+#include <string>
+
+static void assertSameSolution(const SudokuSolver& a, const SudokuSolver& b)
+{
+    for (int r = 0; r < 9; ++r)
+        for (int c = 0; c < 9; ++c)
+        {
+            assert(a.getValue(r, c) >= 1 && a.getValue(r, c) <= 9);
+            assert(a.getValue(r, c) == b.getValue(r, c));
+        }
+}
+
+int main()
+{
+    auto reference = makeSolver(Engine::Propagation, 9);
+    for (const char* name : { "easy", "medium", "hard" })
+    {
+        std::string puzzle = readPuzzle(std::string("boards/9x9/") + name + ".txt");
+        reference->load(puzzle);
+        assert(reference->solve() == SearchStatus::Solved);
+
+        auto sat = makeSolver(Engine::Sat, 9);
+        assert(sat->load(puzzle) == BoardError::None);
+        assert(sat->solve() == SearchStatus::Solved);
+        assertSameSolution(*sat, *reference);
+    }
+
+    // duplicate givens, and a wrong given that only search can refute
+    auto sat = makeSolver(Engine::Sat, 9);
+    sat->load(readPuzzle("boards/9x9/unsolvable.txt"));
+    assert(sat->solve() == SearchStatus::Unsolvable);
+
+    std::string hard = readPuzzle("boards/9x9/hard.txt");
+    reference->load(hard);
+    reference->solve();
+    std::string wrong = hard;
+    for (int i = 0; i < 81; ++i)
+        if (wrong[i] == '0')
+        {
+            int v = reference->getValue(i / 9, i % 9);
+            wrong[i] = char('0' + v % 9 + 1); // any other digit
+            break;
+        }
+    sat->load(wrong);
+    if (sat->isConsistent())
+        assert(sat->solve() == SearchStatus::Unsolvable);
+
+    // counting through blocking clauses
+    sat->load(hard);
+    assert(sat->countSolutions(2) == 1);
+    sat->load(std::string(81, '0'));
+    assert(sat->countSolutions(5) == 5);
+
+    // a board that needs a few hundred search nodes
+    const std::string deep = readPuzzle("boards/9x9/deep.txt");
+    reference->load(deep);
+    assert(reference->solve() == SearchStatus::Solved);
+    assert(reference->nodeCount() > 10);
+
+    // a tiny budget makes the portfolio escalate to SAT; the answer is the same
+    auto portfolio = makeSolver(Engine::Portfolio, 9, 10);
+    portfolio->load(deep);
+    assert(portfolio->solve() == SearchStatus::Solved);
+    assertSameSolution(*portfolio, *reference);
+
+    // under the budget nothing escalates: the propagation engine's search as is
+    portfolio = makeSolver(Engine::Portfolio, 9);
+    portfolio->load(deep);
+    assert(portfolio->solve() == SearchStatus::Solved);
+    assert(portfolio->nodeCount() == reference->nodeCount());
+
+    std::cout << "[OK] SAT engine test passed\n";
+    return 0;
+}
@@ -0,0 +1,43 @@
+#include "helpers.h"
+#include "sudoku.h"
+#include <cassert>
+#include <iostream>
+#include <string>
+
+int main()
+{
+    // a board that needs a few hundred search nodes, with a single solution
+    const std::string deep = readPuzzle("boards/9x9/deep.txt");
+
+    // fewer givens: many solutions to count
+    const std::string open = withoutGivens(deep, 3);
+
+    SudokuBoard cellsOnly(9);
+    cellsOnly.setUnitBranching(false);
+    cellsOnly.load(deep);
+    assert(cellsOnly.solve(SearchLimits{}) == SearchStatus::Solved);
+    const std::string solution = solutionOf(cellsOnly);
+    cellsOnly.load(open);
+    const uint64_t count = cellsOnly.countSolutions(100000);
+    assert(count > 1);
+
+    // unit splits, alone and under backjumping, which has to explain a unit split's failures
+    for (bool backjumping : { false, true })
+        for (StateStrategy strategy : { StateStrategy::Trail, StateStrategy::Snapshot })
+        {
+            SudokuBoard board(9);
+            board.setUnitBranching(true);
+            board.setBackjumping(backjumping);
+            board.setStateStrategy(strategy);
+
+            board.load(deep);
+            assert(board.solve(SearchLimits{}) == SearchStatus::Solved);
+            assert(solutionOf(board) == solution);
+
+            board.load(open);
+            assert(board.countSolutions(100000) == count);
+        }
+
+    std::cout << "[OK] Unit branching test passed\n";
+    return 0;
+}
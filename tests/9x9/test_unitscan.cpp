@@ -0,0 +1,61 @@
+#include "sudoku.h"
+#include "unitscan.h"
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+
+template <typename Mask>
+static void checkKernels(int n, std::mt19937& rng)
+{
+    Mask masks[32];
+    for (int round = 0; round < 2000; ++round)
+    {
+        // mostly sparse masks, so empty and single-bit ones are common
+        for (int p = 0; p < n; ++p)
+        {
+            const Mask wide = Mask(rng() & ((uint64_t(1) << n) - 1));
+            masks[p] = rng() % 3 == 0 ? wide : Mask(wide & -wide);
+        }
+
+        UnitScan expected;
+        for (int p = 0; p < n; ++p)
+        {
+            if (masks[p]) expected.seen |= 1u << p;
+            if (__builtin_popcount(masks[p]) == 1) expected.once |= 1u << p;
+        }
+
+        for (ScanIsa isa : { ScanIsa::Portable, ScanIsa::Sse2, ScanIsa::Avx2 })
+        {
+            if (!scanIsaSupported(isa)) continue;
+            const UnitScan scan = scanUnit(masks, n, isa);
+            assert(scan.once == expected.once && scan.seen == expected.seen);
+        }
+        const UnitScan scan = scanUnit(masks, n);
+        assert(scan.once == expected.once && scan.seen == expected.seen);
+    }
+}
+
+int main()
+{
+    std::mt19937 rng(5);
+    checkKernels<uint16_t>(9, rng);
+    checkKernels<uint16_t>(16, rng);
+    checkKernels<uint32_t>(25, rng);
+
+    // the board's scans: hidden singles still solve, contradictions are still seen
+    const std::string easy = "530070000600195000098000060800060003400803001700020006060000280000419005000080079";
+    SudokuBoard board(9);
+    board.load(easy);
+    assert(!board.hasContradiction());
+    assert(board.solve(SearchLimits{}) == SearchStatus::Solved && board.isSolved());
+
+    std::string unsolvable = easy;
+    unsolvable[2] = '1';
+    board.load(unsolvable);
+    assert(board.solve(SearchLimits{}) == SearchStatus::Unsolvable);
+
+    std::cout << "[OK] Unit scan test passed (" << scanIsaName(bestScanIsa()) << ")\n";
+    return 0;
+}
@@ -0,0 +1,41 @@
+#include "helpers.h"
+#include "sudoku.h"
+#include <cassert>
+#include <iostream>
+#include <string>
+
+int main()
+{
+    // a board that needs a few hundred search nodes, with a single solution
+    const std::string deep = readPuzzle("boards/9x9/deep.txt");
+
+    SudokuBoard reference(9);
+    reference.load(deep);
+    assert(reference.solve(SearchLimits{}) == SearchStatus::Solved);
+    const std::string solution = solutionOf(reference);
+
+    for (ValueOrder order : { ValueOrder::Ascending, ValueOrder::LeastConstraining, ValueOrder::Frequency, ValueOrder::Random })
+    {
+        assert(valueOrderFromName(valueOrderName(order)) == order);
+
+        SudokuBoard board(9);
+        board.setValueOrder(order, 7);
+        board.load(deep);
+        assert(board.solve(SearchLimits{}) == SearchStatus::Solved);
+        assert(solutionOf(board) == solution);
+        const uint64_t nodes = board.nodeCount();
+
+        // the same seed explores the same tree
+        board.load(deep);
+        board.solve(SearchLimits{});
+        assert(board.nodeCount() == nodes);
+
+        // the order changes which solution comes first, not how many there are
+        board.load(std::string(81, '0'));
+        assert(board.countSolutions(50) == 50);
+    }
+    assert(!valueOrderFromName("descending"));
+
+    std::cout << "[OK] Value order test passed\n";
+    return 0;
+}
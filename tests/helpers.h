@@ -0,0 +1,19 @@
+#pragma once
+// helpers.h
+// Shared by the tests of every size. Run the tests from the repository root, like the ones
+// that call loadFromFile.
+
+#include <fstream>
+#include <string>
+
+// a board file's cells, with the characters loadFromFile takes
+inline std::string readPuzzle(const std::string& path)
+{
+    std::ifstream file(path);
+    std::string puzzle;
+    char ch;
+    while (file.get(ch))
+        if ((ch >= '0' && ch <= '9') || (ch >= 'A' && ch <= 'Z') || (ch >= 'a' && ch <= 'z') || ch == '.')
+            puzzle += ch;
+    return puzzle;
+}